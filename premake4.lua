@@ -9,7 +9,7 @@ solution "SampSharp"
         kind "SharedLib"
 
         language "C++"
-        links { "rt" }
+        links { "rt", "pthread" }
 
         includedirs {
             "src/SampSharp/includes",
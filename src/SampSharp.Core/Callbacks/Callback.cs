@@ -16,7 +16,9 @@
 using System;
 using System.Linq;
 using System.Reflection;
+using System.Runtime.InteropServices;
 using SampSharp.Core.Communication;
+using SampSharp.Core.Hosting;
 
 namespace SampSharp.Core.Callbacks
 {
@@ -33,6 +35,8 @@ namespace SampSharp.Core.Callbacks
 
         private readonly object _target;
 
+        private static byte[] _stringBuffer = new byte[256];
+
         /// <summary>
         ///     Initializes a new instance of the <see cref="Callback" /> class.
         /// </summary>
@@ -171,6 +175,97 @@ namespace SampSharp.Core.Callbacks
                 }
             }
 
+            return InvokeMethod();
+        }
+
+        /// <summary>
+        ///     Invokes the callback with the arguments of an AMX call. Strings and arrays are read from the memory of the AMX.
+        /// </summary>
+        /// <param name="amx">The AMX which called the callback.</param>
+        /// <param name="parameters">A pointer to the parameters of the call.</param>
+        /// <returns>The value returned by the callback.</returns>
+        public int? Invoke(IntPtr amx, IntPtr parameters)
+        {
+            for (var i = 0; i < _parameters.Length; i++)
+            {
+                var par = _parameters[i];
+                var type = _parameterInfos[i].ParameterType;
+                var value = Marshal.ReadInt32(parameters, (i + 1) * 4);
+
+                switch (par.Type)
+                {
+                    case CallbackParameterType.Value:
+                        if (type == typeof(int))
+                            _parameterValues[i] = value;
+                        else if (type == typeof(float))
+                            _parameterValues[i] = ValueConverter.ToSingle(value);
+                        else if (type == typeof(bool))
+                            _parameterValues[i] = ValueConverter.ToBoolean(value);
+                        break;
+                    case CallbackParameterType.Array:
+                    {
+                        var length = Math.Max(0, Marshal.ReadInt32(parameters, ((int) par.LengthIndex + 1) * 4));
+                        _parameterValues[i] = ReadArray(amx, value, length, type.GetElementType());
+                        break;
+                    }
+                    case CallbackParameterType.String:
+                        _parameterValues[i] = ReadString(amx, value);
+                        break;
+                    default:
+                        throw new ArgumentOutOfRangeException();
+                }
+            }
+
+            return InvokeMethod();
+        }
+
+        private static Array ReadArray(IntPtr amx, int address, int length, Type elementType)
+        {
+            var values = new int[length];
+
+            if (length > 0)
+            {
+                Interop.GetAmxAddress(amx, address, out var ptr);
+
+                if (ptr != IntPtr.Zero)
+                    Marshal.Copy(ptr, values, 0, length);
+            }
+
+            if (elementType == typeof(int))
+                return values;
+
+            if (elementType == typeof(float))
+            {
+                var floats = new float[length];
+                for (var j = 0; j < length; j++)
+                    floats[j] = ValueConverter.ToSingle(values[j]);
+                return floats;
+            }
+
+            var bools = new bool[length];
+            for (var j = 0; j < length; j++)
+                bools[j] = ValueConverter.ToBoolean(values[j]);
+            return bools;
+        }
+
+        private string ReadString(IntPtr amx, int address)
+        {
+            var length = _stringBuffer.Length;
+            Interop.GetAmxString(amx, address, _stringBuffer, ref length);
+
+            if (length >= _stringBuffer.Length)
+            {
+                // The string did not fit the buffer; read it again in a buffer of sufficient size.
+                _stringBuffer = new byte[length + 1];
+                length = _stringBuffer.Length;
+                Interop.GetAmxString(amx, address, _stringBuffer, ref length);
+            }
+
+            return _gameModeClient.Encoding.GetString(_stringBuffer, 0, length);
+        }
+
+        private int? InvokeMethod()
+        {
             var result = _methodInfo.Invoke(_target, _parameterValues);
 
             if (result is int)
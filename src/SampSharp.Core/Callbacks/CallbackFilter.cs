@@ -0,0 +1,170 @@
+﻿// SampSharp
+// Copyright 2018 Tim Potze
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using SampSharp.Core.Communication;
+
+namespace SampSharp.Core.Callbacks
+{
+    /// <summary>
+    ///     Represents a set of predicates which are evaluated by the server before a callback is forwarded to the game mode.
+    ///     A call is only forwarded if all predicates pass; otherwise the server returns the default return value.
+    /// </summary>
+    public sealed class CallbackFilter
+    {
+        private const byte End = 0x00;
+        private const byte PrefixPredicate = 0x01;
+        private const byte MaskPredicate = 0x02;
+        private const byte RangePredicate = 0x03;
+        private const byte RejectPredicate = 0x04;
+        private const byte NoArgument = 0xff;
+        private const byte WholeWordFlag = 1 << 0;
+        private const byte IgnoreCaseFlag = 1 << 1;
+
+        private readonly List<byte> _predicates = new List<byte>();
+
+        /// <summary>
+        ///     Initializes a new instance of the <see cref="CallbackFilter" /> class.
+        /// </summary>
+        /// <param name="defaultReturnValue">The value returned by the server for calls which are not forwarded.</param>
+        public CallbackFilter(int defaultReturnValue = 1)
+        {
+            DefaultReturnValue = defaultReturnValue;
+        }
+
+        /// <summary>
+        ///     Gets the value returned by the server for calls which are not forwarded.
+        /// </summary>
+        public int DefaultReturnValue { get; }
+
+        /// <summary>
+        ///     Adds a predicate which passes if the string argument at the specified <paramref name="argumentIndex" /> starts
+        ///     with one of the specified <paramref name="prefixes" />.
+        /// </summary>
+        /// <param name="argumentIndex">The index of the string argument.</param>
+        /// <param name="prefixes">The prefixes, for example the commands registered by the game mode.</param>
+        /// <param name="wholeWord">If set to <c>true</c> a prefix must be followed by a space or the end of the string.</param>
+        /// <param name="ignoreCase">If set to <c>true</c> prefixes are compared case insensitive.</param>
+        /// <param name="encoding">The encoding of the prefixes.</param>
+        /// <returns>This filter.</returns>
+        public CallbackFilter Prefix(int argumentIndex, IEnumerable<string> prefixes, bool wholeWord = true, bool ignoreCase = true,
+            Encoding encoding = null)
+        {
+            if (prefixes == null) throw new ArgumentNullException(nameof(prefixes));
+
+            var list = prefixes.ToArray();
+
+            _predicates.Add(PrefixPredicate);
+            _predicates.Add(GetArgumentIndex(argumentIndex));
+            _predicates.Add((byte) ((wholeWord ? WholeWordFlag : 0) | (ignoreCase ? IgnoreCaseFlag : 0)));
+            _predicates.AddRange(ValueConverter.GetBytes(list.Length));
+
+            foreach (var prefix in list)
+                _predicates.AddRange(ValueConverter.GetBytes(prefix, encoding ?? Encoding.ASCII));
+
+            return this;
+        }
+
+        /// <summary>
+        ///     Adds a predicate which passes if the value argument at the specified <paramref name="argumentIndex" /> has any
+        ///     of the bits of the specified <paramref name="mask" /> set.
+        /// </summary>
+        /// <param name="argumentIndex">The index of the value argument.</param>
+        /// <param name="mask">The mask.</param>
+        /// <returns>This filter.</returns>
+        public CallbackFilter Mask(int argumentIndex, int mask)
+        {
+            _predicates.Add(MaskPredicate);
+            _predicates.Add(GetArgumentIndex(argumentIndex));
+            _predicates.Add(NoArgument);
+            _predicates.AddRange(ValueConverter.GetBytes(mask));
+
+            return this;
+        }
+
+        /// <summary>
+        ///     Adds a predicate which passes if any of the bits of the specified <paramref name="mask" /> differ between the
+        ///     value arguments at the specified indices, for example the new and old keys of OnPlayerKeyStateChange.
+        /// </summary>
+        /// <param name="argumentIndex">The index of the first value argument.</param>
+        /// <param name="otherArgumentIndex">The index of the second value argument.</param>
+        /// <param name="mask">The mask.</param>
+        /// <returns>This filter.</returns>
+        public CallbackFilter ChangedMask(int argumentIndex, int otherArgumentIndex, int mask)
+        {
+            _predicates.Add(MaskPredicate);
+            _predicates.Add(GetArgumentIndex(argumentIndex));
+            _predicates.Add(GetArgumentIndex(otherArgumentIndex));
+            _predicates.AddRange(ValueConverter.GetBytes(mask));
+
+            return this;
+        }
+
+        /// <summary>
+        ///     Adds a predicate which passes if the value argument at the specified <paramref name="argumentIndex" /> lies
+        ///     within the specified inclusive range.
+        /// </summary>
+        /// <param name="argumentIndex">The index of the value argument.</param>
+        /// <param name="min">The minimum value.</param>
+        /// <param name="max">The maximum value.</param>
+        /// <returns>This filter.</returns>
+        public CallbackFilter Range(int argumentIndex, int min, int max)
+        {
+            _predicates.Add(RangePredicate);
+            _predicates.Add(GetArgumentIndex(argumentIndex));
+            _predicates.AddRange(ValueConverter.GetBytes(min));
+            _predicates.AddRange(ValueConverter.GetBytes(max));
+
+            return this;
+        }
+
+        /// <summary>
+        ///     Adds a predicate which never passes.
+        /// </summary>
+        /// <returns>This filter.</returns>
+        public CallbackFilter Reject()
+        {
+            _predicates.Add(RejectPredicate);
+
+            return this;
+        }
+
+        private static byte GetArgumentIndex(int argumentIndex)
+        {
+            if (argumentIndex < 0 || argumentIndex >= NoArgument)
+                throw new ArgumentOutOfRangeException(nameof(argumentIndex));
+
+            return (byte) argumentIndex;
+        }
+
+        /// <summary>
+        ///     Gets the byte representation of the filter for the callback with the specified <paramref name="name" />.
+        /// </summary>
+        /// <param name="name">The name of the callback.</param>
+        /// <param name="encoding">The encoding of the name.</param>
+        /// <returns>The bytes.</returns>
+        public byte[] GetBytes(string name, Encoding encoding)
+        {
+            return ValueConverter.GetBytes(name, encoding)
+                .Concat(ValueConverter.GetBytes(DefaultReturnValue))
+                .Concat(_predicates)
+                .Concat(new[] { End })
+                .ToArray();
+        }
+    }
+}
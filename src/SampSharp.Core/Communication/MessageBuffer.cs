@@ -15,6 +15,7 @@
 
 using System;
 using System.Collections.Generic;
+using SampSharp.Core.Logging;
 
 namespace SampSharp.Core.Communication
 {
@@ -23,33 +24,84 @@ namespace SampSharp.Core.Communication
     /// </summary>
     public class MessageBuffer
     {
+        private const int ChunkHeaderLength = 5;
+
         private readonly Queue<byte> _queue = new Queue<byte>(1000);
         private byte _command;
         private uint _commandLength;
         private bool _localFill;
+        private byte[] _chunkData;
+        private ServerCommand _chunkCommand;
+        private int _chunkPosition;
 
         /// <summary>
-        ///     Tries to pop a server command from the buffer.
+        ///     Tries to pop a server command from the buffer. Chunked commands are only popped once all chunks have been
+        ///     received.
         /// </summary>
         /// <param name="command">The popped command.</param>
         /// <returns>true if a command has been popped of the buffer; false otherwise.</returns>
         public bool TryPop(out ServerCommandData command)
         {
-            if (!MessageAvailable())
+            while (MessageAvailable())
+            {
+                var data = new byte[_commandLength];
+                for (var i = 0; i < _commandLength; i++)
+                {
+                    data[i] = _queue.Dequeue();
+                }
+
+                _localFill = false;
+
+                if ((ServerCommand) _command != ServerCommand.Chunk)
+                {
+                    command = new ServerCommandData((ServerCommand) _command, data);
+                    return true;
+                }
+
+                if (TryAppendChunk(data, out command))
+                    return true;
+            }
+
+            command = default(ServerCommandData);
+            return false;
+        }
+
+        private bool TryAppendChunk(byte[] chunk, out ServerCommandData command)
+        {
+            command = default(ServerCommandData);
+
+            if (chunk.Length < ChunkHeaderLength)
             {
-                command = default(ServerCommandData);
+                CoreLog.Log(CoreLogLevel.Error, "Received an invalid command chunk.");
                 return false;
             }
 
-            var data = new byte[_commandLength];
-            for (var i = 0; i < _commandLength; i++)
+            var chunkCommand = (ServerCommand) chunk[0];
+            var length = ValueConverter.ToInt32(chunk, 1);
+
+            if (_chunkData == null)
             {
-                data[i] = _queue.Dequeue();
+                _chunkData = new byte[length];
+                _chunkCommand = chunkCommand;
+                _chunkPosition = 0;
             }
 
-            _localFill = false;
+            if (chunkCommand != _chunkCommand || length != _chunkData.Length ||
+                chunk.Length - ChunkHeaderLength > _chunkData.Length - _chunkPosition)
+            {
+                CoreLog.Log(CoreLogLevel.Error, "Received an invalid command chunk.");
+                _chunkData = null;
+                return false;
+            }
+
+            Array.Copy(chunk, ChunkHeaderLength, _chunkData, _chunkPosition, chunk.Length - ChunkHeaderLength);
+            _chunkPosition += chunk.Length - ChunkHeaderLength;
+
+            if (_chunkPosition < _chunkData.Length)
+                return false;
 
-            command = new ServerCommandData((ServerCommand) _command, data);
+            command = new ServerCommandData(_chunkCommand, _chunkData);
+            _chunkData = null;
             return true;
         }
 
@@ -113,6 +165,7 @@ namespace SampSharp.Core.Communication
         public void Clear()
         {
             _localFill = false;
+            _chunkData = null;
             _queue.Clear();
         }
     }
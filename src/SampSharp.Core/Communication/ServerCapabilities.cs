@@ -0,0 +1,61 @@
+﻿// SampSharp
+// Copyright 2018 Tim Potze
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+using System;
+
+namespace SampSharp.Core.Communication
+{
+    /// <summary>
+    ///     Contains the capabilities which can be negotiated with the SampSharp server during the announcement handshake.
+    /// </summary>
+    [Flags]
+    public enum ServerCapabilities : uint
+    {
+        /// <summary>
+        ///     No capabilities.
+        /// </summary>
+        None = 0,
+
+        /// <summary>
+        ///     Frames larger than the maximum frame size are split into chunks.
+        /// </summary>
+        ChunkedFrames = 1 << 0,
+
+        /// <summary>
+        ///     Frame payloads may be compressed.
+        /// </summary>
+        Compression = 1 << 1,
+
+        /// <summary>
+        ///     Multiple natives may be invoked using a single frame.
+        /// </summary>
+        Batching = 1 << 2,
+
+        /// <summary>
+        ///     Callbacks which do not require a return value are sent without waiting for a response.
+        /// </summary>
+        AsyncCallbacks = 1 << 3,
+
+        /// <summary>
+        ///     Frames may be exchanged through shared memory.
+        /// </summary>
+        SharedMemory = 1 << 4,
+
+        /// <summary>
+        ///     Callbacks may be called as dry runs to warm up the game mode.
+        /// </summary>
+        DryRunCalls = 1 << 5
+    }
+}
@@ -68,6 +68,38 @@ namespace SampSharp.Core.Communication
         /// </summary>
         Disconnect = 0x09,
 
+        /// <summary>
+        ///     A reply which can be sent to the server after an <see cref="Announce" /> to indicate which of the announced
+        ///     capabilities the client accepts.
+        /// </summary>
+        Capabilities = 0x0a,
+
+        /// <summary>
+        ///     A chunk of a command which is larger than the maximum frame size. Can be sent to and received from the server
+        ///     if <see cref="ServerCapabilities.ChunkedFrames" /> has been negotiated.
+        /// </summary>
+        Chunk = 0x0b,
+
+        /// <summary>
+        ///     An instruction which can be sent to the server to set the caching policy of a native.
+        /// </summary>
+        NativeCache = 0x0c,
+
+        /// <summary>
+        ///     An instruction which can be sent to the server to set the attributes gathered in the entity snapshot.
+        /// </summary>
+        Snapshot = 0x0d,
+
+        /// <summary>
+        ///     An instruction which can be sent to the server to find the entities within a radius of a point.
+        /// </summary>
+        QueryRadius = 0x0e,
+
+        /// <summary>
+        ///     An instruction which can be sent to the server to set the filter of a callback.
+        /// </summary>
+        CallbackFilter = 0x0f,
+
         /// <summary>
         ///     An instruction telling the server the client is still alive.
         /// </summary>
@@ -97,6 +129,17 @@ namespace SampSharp.Core.Communication
         /// <summary>
         ///     An announcement sent by the server after connecting to the server.
         /// </summary>
-        Announce = 0x15
+        Announce = 0x15,
+
+        /// <summary>
+        ///     The changes of the entity snapshot sent by the server before every <see cref="Tick" />.
+        /// </summary>
+        SnapshotFrame = 0x16,
+
+        /// <summary>
+        ///     A <see cref="PublicCall" /> with synthetic arguments sent by the server to warm up the game mode. Handlers
+        ///     should skip side effects.
+        /// </summary>
+        DryRunCall = 0x17
     }
 }
\ No newline at end of file
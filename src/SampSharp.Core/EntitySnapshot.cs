@@ -0,0 +1,292 @@
+﻿// SampSharp
+// Copyright 2018 Tim Potze
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+using System;
+using System.Runtime.InteropServices;
+using SampSharp.Core.Communication;
+
+namespace SampSharp.Core
+{
+    /// <summary>
+    ///     Represents the state of players and vehicles gathered by the server at the start of every tick.
+    /// </summary>
+    /// <remarks>
+    ///     The snapshot is stored as a structure of arrays of cells: a header containing the gathered attributes and the
+    ///     player and vehicle pool sizes, followed by the player connected flags, an array per component of every gathered
+    ///     player attribute, the vehicle exists flags and an array per component of every gathered vehicle attribute.
+    /// </remarks>
+    public sealed class EntitySnapshot
+    {
+        private const int HeaderCells = 3;
+        private const int CellSize = 4;
+        private const int FrameHeaderSize = 5;
+        private const int RunHeaderSize = 8;
+
+        private static readonly byte[] Empty = new byte[0];
+
+        private readonly int[] _offsets = new int[32];
+        private IntPtr _pointer;
+        private byte[] _data = Empty;
+        private int _cells;
+        private int _playersOffset;
+        private int _vehiclesOffset;
+
+        /// <summary>
+        ///     Gets the attributes contained in this snapshot.
+        /// </summary>
+        public EntitySnapshotAttributes Attributes { get; private set; }
+
+        /// <summary>
+        ///     Gets the number of player slots in this snapshot.
+        /// </summary>
+        public int PlayerCount { get; private set; }
+
+        /// <summary>
+        ///     Gets the number of vehicle slots in this snapshot.
+        /// </summary>
+        public int VehicleCount { get; private set; }
+
+        #region Updating
+
+        /// <summary>
+        ///     Uses the snapshot stored at the specified <paramref name="pointer" /> by the server.
+        /// </summary>
+        internal void Attach(IntPtr pointer)
+        {
+            _pointer = pointer;
+            _data = Empty;
+            UpdateLayout();
+        }
+
+        /// <summary>
+        ///     Discards the contents of this snapshot.
+        /// </summary>
+        internal void Reset()
+        {
+            _pointer = IntPtr.Zero;
+            _data = Empty;
+            _cells = 0;
+            UpdateLayout();
+        }
+
+        /// <summary>
+        ///     Applies a delta-encoded frame received from the server.
+        /// </summary>
+        internal void Apply(byte[] frame)
+        {
+            if (frame == null || frame.Length < FrameHeaderSize)
+                throw new ArgumentException("Invalid snapshot frame.", nameof(frame));
+
+            var keyframe = frame[0] != 0;
+            var cells = ValueConverter.ToInt32(frame, 1);
+
+            if (keyframe)
+            {
+                if (_data.Length != cells * CellSize)
+                    _data = new byte[cells * CellSize];
+
+                Buffer.BlockCopy(frame, FrameHeaderSize, _data, 0, cells * CellSize);
+                _cells = cells;
+            }
+            else
+            {
+                if (cells != _cells)
+                    throw new InvalidOperationException("Snapshot frame does not match the current snapshot.");
+
+                for (var position = FrameHeaderSize; position + RunHeaderSize <= frame.Length;)
+                {
+                    var offset = ValueConverter.ToInt32(frame, position);
+                    var count = ValueConverter.ToInt32(frame, position + 4);
+                    position += RunHeaderSize;
+
+                    Buffer.BlockCopy(frame, position, _data, offset * CellSize, count * CellSize);
+                    position += count * CellSize;
+                }
+            }
+
+            UpdateLayout();
+        }
+
+        /// <summary>
+        ///     Reads the layout of the snapshot from its header.
+        /// </summary>
+        internal void UpdateLayout()
+        {
+            if (_pointer == IntPtr.Zero && _cells < HeaderCells)
+            {
+                Attributes = EntitySnapshotAttributes.None;
+                PlayerCount = 0;
+                VehicleCount = 0;
+                return;
+            }
+
+            Attributes = (EntitySnapshotAttributes) ReadCell(0);
+            PlayerCount = ReadCell(1);
+            VehicleCount = ReadCell(2);
+
+            var offset = HeaderCells;
+            _playersOffset = offset;
+            offset += PlayerCount;
+
+            for (var bit = 0; bit < 32; bit++)
+            {
+                if (bit == 16)
+                {
+                    _vehiclesOffset = offset;
+                    offset += VehicleCount;
+                }
+
+                var attribute = (EntitySnapshotAttributes) (1u << bit);
+                if ((Attributes & attribute) == 0)
+                {
+                    _offsets[bit] = -1;
+                    continue;
+                }
+
+                var count = bit < 16 ? PlayerCount : VehicleCount;
+                var components = attribute == EntitySnapshotAttributes.PlayerPosition ||
+                                 attribute == EntitySnapshotAttributes.VehiclePosition
+                    ? 3
+                    : 1;
+
+                _offsets[bit] = offset;
+                offset += count * components;
+            }
+        }
+
+        #endregion
+
+        #region Reading
+
+        private int ReadCell(int index)
+        {
+            return _pointer != IntPtr.Zero
+                ? Marshal.ReadInt32(_pointer, index * CellSize)
+                : ValueConverter.ToInt32(_data, index * CellSize);
+        }
+
+        private int ReadAttribute(EntitySnapshotAttributes attribute, int id, int component = 0)
+        {
+            var bit = 0;
+            while ((1u << bit) != (uint) attribute)
+                bit++;
+
+            var count = bit < 16 ? PlayerCount : VehicleCount;
+            if ((Attributes & attribute) == 0)
+                throw new InvalidOperationException($"The snapshot does not contain {attribute}.");
+
+            return id < 0 || id >= count ? 0 : ReadCell(_offsets[bit] + component * count + id);
+        }
+
+        private float ReadAttributeSingle(EntitySnapshotAttributes attribute, int id, int component = 0)
+        {
+            return ValueConverter.ToSingle(ReadAttribute(attribute, id, component));
+        }
+
+        /// <summary>
+        ///     Gets a value indicating whether the player with the specified <paramref name="playerid" /> is connected.
+        /// </summary>
+        public bool IsPlayerConnected(int playerid)
+        {
+            return playerid >= 0 && playerid < PlayerCount && ReadCell(_playersOffset + playerid) != 0;
+        }
+
+        /// <summary>
+        ///     Gets the position of the player with the specified <paramref name="playerid" />.
+        /// </summary>
+        public void GetPlayerPosition(int playerid, out float x, out float y, out float z)
+        {
+            x = ReadAttributeSingle(EntitySnapshotAttributes.PlayerPosition, playerid);
+            y = ReadAttributeSingle(EntitySnapshotAttributes.PlayerPosition, playerid, 1);
+            z = ReadAttributeSingle(EntitySnapshotAttributes.PlayerPosition, playerid, 2);
+        }
+
+        /// <summary>
+        ///     Gets the health of the player with the specified <paramref name="playerid" />.
+        /// </summary>
+        public float GetPlayerHealth(int playerid)
+        {
+            return ReadAttributeSingle(EntitySnapshotAttributes.PlayerHealth, playerid);
+        }
+
+        /// <summary>
+        ///     Gets the armour of the player with the specified <paramref name="playerid" />.
+        /// </summary>
+        public float GetPlayerArmour(int playerid)
+        {
+            return ReadAttributeSingle(EntitySnapshotAttributes.PlayerArmour, playerid);
+        }
+
+        /// <summary>
+        ///     Gets the state of the player with the specified <paramref name="playerid" />.
+        /// </summary>
+        public int GetPlayerState(int playerid)
+        {
+            return ReadAttribute(EntitySnapshotAttributes.PlayerState, playerid);
+        }
+
+        /// <summary>
+        ///     Gets the identifier of the vehicle the player with the specified <paramref name="playerid" /> is in.
+        /// </summary>
+        public int GetPlayerVehicle(int playerid)
+        {
+            return ReadAttribute(EntitySnapshotAttributes.PlayerVehicle, playerid);
+        }
+
+        /// <summary>
+        ///     Gets the facing angle of the player with the specified <paramref name="playerid" />.
+        /// </summary>
+        public float GetPlayerFacingAngle(int playerid)
+        {
+            return ReadAttributeSingle(EntitySnapshotAttributes.PlayerFacingAngle, playerid);
+        }
+
+        /// <summary>
+        ///     Gets a value indicating whether the vehicle with the specified <paramref name="vehicleid" /> exists.
+        /// </summary>
+        public bool VehicleExists(int vehicleid)
+        {
+            return vehicleid >= 0 && vehicleid < VehicleCount && ReadCell(_vehiclesOffset + vehicleid) != 0;
+        }
+
+        /// <summary>
+        ///     Gets the position of the vehicle with the specified <paramref name="vehicleid" />.
+        /// </summary>
+        public void GetVehiclePosition(int vehicleid, out float x, out float y, out float z)
+        {
+            x = ReadAttributeSingle(EntitySnapshotAttributes.VehiclePosition, vehicleid);
+            y = ReadAttributeSingle(EntitySnapshotAttributes.VehiclePosition, vehicleid, 1);
+            z = ReadAttributeSingle(EntitySnapshotAttributes.VehiclePosition, vehicleid, 2);
+        }
+
+        /// <summary>
+        ///     Gets the health of the vehicle with the specified <paramref name="vehicleid" />.
+        /// </summary>
+        public float GetVehicleHealth(int vehicleid)
+        {
+            return ReadAttributeSingle(EntitySnapshotAttributes.VehicleHealth, vehicleid);
+        }
+
+        /// <summary>
+        ///     Gets the rotation angle of the vehicle with the specified <paramref name="vehicleid" />.
+        /// </summary>
+        public float GetVehicleAngle(int vehicleid)
+        {
+            return ReadAttributeSingle(EntitySnapshotAttributes.VehicleAngle, vehicleid);
+        }
+
+        #endregion
+    }
+}
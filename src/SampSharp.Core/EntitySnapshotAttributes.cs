@@ -0,0 +1,77 @@
+﻿// SampSharp
+// Copyright 2018 Tim Potze
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+using System;
+
+namespace SampSharp.Core
+{
+    /// <summary>
+    ///     Contains the player and vehicle attributes which can be gathered by the server in an <see cref="EntitySnapshot" />
+    ///     every tick.
+    /// </summary>
+    [Flags]
+    public enum EntitySnapshotAttributes : uint
+    {
+        /// <summary>
+        ///     No attributes are gathered.
+        /// </summary>
+        None = 0,
+
+        /// <summary>
+        ///     The position of players.
+        /// </summary>
+        PlayerPosition = 1 << 0,
+
+        /// <summary>
+        ///     The health of players.
+        /// </summary>
+        PlayerHealth = 1 << 1,
+
+        /// <summary>
+        ///     The armour of players.
+        /// </summary>
+        PlayerArmour = 1 << 2,
+
+        /// <summary>
+        ///     The state of players.
+        /// </summary>
+        PlayerState = 1 << 3,
+
+        /// <summary>
+        ///     The identifier of the vehicle players are in.
+        /// </summary>
+        PlayerVehicle = 1 << 4,
+
+        /// <summary>
+        ///     The facing angle of players.
+        /// </summary>
+        PlayerFacingAngle = 1 << 5,
+
+        /// <summary>
+        ///     The position of vehicles.
+        /// </summary>
+        VehiclePosition = 1 << 16,
+
+        /// <summary>
+        ///     The health of vehicles.
+        /// </summary>
+        VehicleHealth = 1 << 17,
+
+        /// <summary>
+        ///     The rotation angle of vehicles.
+        /// </summary>
+        VehicleAngle = 1 << 18
+    }
+}
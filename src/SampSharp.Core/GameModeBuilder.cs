@@ -22,6 +22,7 @@ using System.Runtime.InteropServices;
 using System.Text;
 using SampSharp.Core.CodePages;
 using SampSharp.Core.Communication.Clients;
+using SampSharp.Core.Hosting;
 using SampSharp.Core.Logging;
 
 namespace SampSharp.Core
@@ -39,6 +40,7 @@ namespace SampSharp.Core
         private GameModeStartBehaviour _startBehaviour = GameModeStartBehaviour.Gmx;
         private Encoding _encoding;
         private bool _hosted;
+        private IntPtr _hostedApi;
         private TextWriter _logWriter;
         private bool _logWriterSet;
         
@@ -360,6 +362,15 @@ namespace SampSharp.Core
                     case "-h":
                         UseHosted();
                         break;
+                    case "--api":
+                        if (value == null)
+                            break;
+
+                        if (long.TryParse(value, out var api))
+                            _hostedApi = new IntPtr(api);
+
+                        i++;
+                        break;
                     case "--redirect-console-output":
                     case "-r":
                         RedirectConsoleOutput();
@@ -466,7 +477,10 @@ namespace SampSharp.Core
 
             if (_hosted)
             {
-                return new HostedGameModeClient(_startBehaviour, _gameModeProvider, _encoding);
+                return new HostedGameModeClient(_startBehaviour, _gameModeProvider, _encoding)
+                {
+                    Api = HostedApi.Bind(_hostedApi)
+                };
             }
             else
             {
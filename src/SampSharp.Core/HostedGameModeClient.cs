@@ -21,13 +21,18 @@ namespace SampSharp.Core
     /// </summary>
     public sealed class HostedGameModeClient : IGameModeClient, IGameModeRunner
     {
+        private const int MaxQueryResults = 1000 + 2000; // all players and vehicles
+        private const int MaxBatchResponseSize = 1024 * 1024 * 16;
         private readonly Dictionary<string, Callback> _callbacks = new Dictionary<string, Callback>();
+        private readonly List<Callback> _callbacksById = new List<Callback>();
+        private readonly int[] _queryBuffer = new int[MaxQueryResults];
         private NoWaitMessageQueue _messageQueue;
         private SampSharpSyncronizationContext _syncronizationContext;
         private readonly GameModeStartBehaviour _startBehaviour;
         private readonly IGameModeProvider _gameModeProvider;
         private int _mainThread;
         private int _rconThread = int.MinValue;
+        private int _tickThread = int.MinValue;
         private bool _running;
 
         /// <summary>
@@ -54,7 +59,7 @@ namespace SampSharp.Core
             get
             {
                 var id = Thread.CurrentThread.ManagedThreadId;
-                return _mainThread == id || _rconThread == id;
+                return _mainThread == id || _rconThread == id || _tickThread == id;
             }
         }
 
@@ -71,6 +76,10 @@ namespace SampSharp.Core
 
         internal void Tick()
         {
+            // The server may run ticks and callbacks on a dedicated thread; calls made on that thread are serialized
+            // with the calls on the main thread by the server.
+            _tickThread = Thread.CurrentThread.ManagedThreadId;
+
             // Pump new tasks
             var message = _messageQueue.GetMessage();
 
@@ -86,6 +95,8 @@ namespace SampSharp.Core
                 }
             }
 
+            Snapshot.UpdateLayout();
+
             _gameModeProvider.Tick();
         }
 
@@ -109,6 +120,93 @@ namespace SampSharp.Core
             return 1;
         }
 
+        internal int DryRunCall(int id, IntPtr amx, IntPtr parameters)
+        {
+            IsDryRun = true;
+            try
+            {
+                return DirectCall(id, amx, parameters);
+            }
+            catch (Exception e)
+            {
+                OnUnhandledException(new UnhandledExceptionEventArgs(e));
+                return 1;
+            }
+            finally
+            {
+                IsDryRun = false;
+            }
+        }
+
+        internal int DirectCall(int id, IntPtr amx, IntPtr parameters)
+        {
+            if (id < 0 || id >= _callbacksById.Count)
+                return 1;
+
+            var callback = _callbacksById[id];
+
+            if (callback == null)
+                return 1;
+
+            if (callback.Name == "OnRconCommand")
+                _rconThread = Thread.CurrentThread.ManagedThreadId;
+
+            return callback.Invoke(amx, parameters) ?? 1;
+        }
+
+        internal void Restart()
+        {
+            // The runtime and the registered callbacks and natives are kept; the server has reset the state of the
+            // exited game mode, including its callback filters and snapshot attributes.
+            CoreLog.Log(CoreLogLevel.Debug, "Game mode exited; the runtime is kept.");
+
+            Snapshot.Reset();
+
+            try
+            {
+                GameModeRestarted?.Invoke(this, EventArgs.Empty);
+            }
+            catch (Exception e)
+            {
+                OnUnhandledException(new UnhandledExceptionEventArgs(e));
+            }
+        }
+
+        /// <summary>
+        ///     Occurs when the game mode has exited and the server keeps the runtime for the next game mode. Handlers
+        ///     can reset state which should not carry over to the next game mode.
+        /// </summary>
+        public event EventHandler GameModeRestarted;
+
+        /// <summary>
+        ///     Gets or sets the table of functions handed to the game mode by the server.
+        /// </summary>
+        internal HostedApi Api { get; set; }
+
+        internal bool TryInvokeValues(int handle, int[] values, out int result)
+        {
+            if (Api?.InvokeValues == null)
+            {
+                result = 0;
+                return false;
+            }
+
+            result = Api.InvokeValues(handle, values, values.Length);
+            return true;
+        }
+
+        internal bool TryInvokeIntFloat3(int handle, int a, float x, float y, float z, out int result)
+        {
+            if (Api?.InvokeIntFloat3 == null)
+            {
+                result = 0;
+                return false;
+            }
+
+            result = Api.InvokeIntFloat3(handle, a, x, y, z);
+            return true;
+        }
+
         #region Implementation of IGameModeClient
 
         /// <summary>
@@ -150,7 +248,8 @@ namespace SampSharp.Core
             if (!Callback.IsValidReturnType(methodInfo.ReturnType))
                 throw new CallbackRegistrationException("The method uses an unsupported return type");
 
-            _callbacks[name] = new Callback(target, methodInfo, name, parameters, this);
+            var callback = new Callback(target, methodInfo, name, parameters, this);
+            _callbacks[name] = callback;
 
             var data = ValueConverter.GetBytes(name, Encoding)
                 .Concat(parameters.SelectMany(c => c.GetBytes()))
@@ -160,14 +259,49 @@ namespace SampSharp.Core
             var ptr = Marshal.AllocHGlobal(data.Length);
             Marshal.Copy(data, 0, ptr, data.Length);
 
+            // The server passes calls to callbacks with an identifier directly, without serializing the arguments.
+            var id = -1;
             if (IsOnMainThread)
-                Interop.RegisterCallback(ptr);
+                Interop.RegisterCallback(ptr, out id);
             else
-                _syncronizationContext.Send(ctx => Interop.RegisterCallback(ptr), null);
+                _syncronizationContext.Send(ctx => Interop.RegisterCallback(ptr, out id), null);
 
             Marshal.FreeHGlobal(ptr);
+
+            if (id >= 0)
+            {
+                while (_callbacksById.Count <= id)
+                    _callbacksById.Add(null);
+
+                _callbacksById[id] = callback;
+            }
         }
         
+        /// <summary>
+        ///     Sets the filter the server evaluates before forwarding calls to the callback with the specified
+        ///     <paramref name="name" />. Calls which do not pass the filter are not sent to the game mode.
+        /// </summary>
+        /// <param name="name">The name of the callback.</param>
+        /// <param name="filter">The filter or <c>null</c> to remove the filter.</param>
+        public void SetCallbackFilter(string name, CallbackFilter filter)
+        {
+            if (name == null) throw new ArgumentNullException(nameof(name));
+
+            AssertRunning();
+
+            var data = (filter ?? new CallbackFilter()).GetBytes(name, Encoding);
+
+            var ptr = Marshal.AllocHGlobal(data.Length);
+            Marshal.Copy(data, 0, ptr, data.Length);
+
+            if (IsOnMainThread)
+                Interop.RegisterFilter(ptr, data.Length);
+            else
+                _syncronizationContext.Send(ctx => Interop.RegisterFilter(ptr, data.Length), null);
+
+            Marshal.FreeHGlobal(ptr);
+        }
+
         /// <summary>
         ///     Prints the specified text to the server console.
         /// </summary>
@@ -188,10 +322,49 @@ namespace SampSharp.Core
         public int GetNativeHandle(string name)
         {
             if (IsOnMainThread)
-                return Interop.GetNativeHandle(name);
+                return GetNativeHandleOnMainThread(name);
 
             var result = 0;
-            _syncronizationContext.Send(ctx => result = Interop.GetNativeHandle(name), null);
+            _syncronizationContext.Send(ctx => result = GetNativeHandleOnMainThread(name), null);
+            return result;
+        }
+
+        private int GetNativeHandleOnMainThread(string name)
+        {
+            return Api?.GetNativeHandle?.Invoke(name) ?? Interop.GetNativeHandle(name);
+        }
+
+        /// <summary>
+        ///     Finds the entities within the specified <paramref name="radius" /> of a point. Positions are indexed by the
+        ///     server once per tick.
+        /// </summary>
+        /// <param name="targets">The kinds of entities to find.</param>
+        /// <param name="x">The x-coordinate of the point.</param>
+        /// <param name="y">The y-coordinate of the point.</param>
+        /// <param name="z">The z-coordinate of the point.</param>
+        /// <param name="radius">The radius.</param>
+        /// <returns>The identifiers of the entities found.</returns>
+        public int[] QueryRadius(SpatialQueryTargets targets, float x, float y, float z, float radius)
+        {
+            if (IsOnMainThread)
+                return QueryRadiusOnMainThread(targets, x, y, z, radius);
+
+            int[] result = null;
+            _syncronizationContext.Send(ctx => result = QueryRadiusOnMainThread(targets, x, y, z, radius), null);
+            return result;
+        }
+
+        private int[] QueryRadiusOnMainThread(SpatialQueryTargets targets, float x, float y, float z, float radius)
+        {
+            var ids = _queryBuffer;
+            var count = ids.Length;
+            Interop.QueryRadius((uint) targets, x, y, z, radius, ids, ref count);
+
+            if (count > ids.Length)
+                count = ids.Length;
+
+            var result = new int[count];
+            Array.Copy(ids, result, count);
             return result;
         }
 
@@ -211,7 +384,11 @@ namespace SampSharp.Core
             var outbuf = Marshal.AllocHGlobal(1024);// TODO proper allocation/ global buf
             int outlen = 1024;
             
-            if (IsOnMainThread)
+            // The server queues natives invoked through the function table off the main thread and invokes them during the
+            // next tick, so the call does not have to wait for the synchronization context.
+            if (Api?.InvokeNative != null)
+                Api.InvokeNative(inbuf, adata.Length, outbuf, ref outlen);
+            else if (IsOnMainThread)
                 Interop.InvokeNative(inbuf, adata.Length, outbuf, ref outlen);
             else
                 _syncronizationContext.Send(ctx => Interop.InvokeNative(inbuf, adata.Length, outbuf, ref outlen), null);
@@ -224,6 +401,137 @@ namespace SampSharp.Core
             return outarr;
         }
 
+        /// <summary>
+        ///     Invokes a sequence of natives using the specified <paramref name="calls" /> buffers in a single call to the
+        ///     server.
+        /// </summary>
+        /// <param name="calls">The data buffers of the natives to invoke.</param>
+        /// <returns>The responses of the natives.</returns>
+        public byte[][] InvokeNatives(IList<byte[]> calls)
+        {
+            if (calls == null) throw new ArgumentNullException(nameof(calls));
+
+            if (Api?.InvokeBatch == null)
+                return calls.Select(InvokeNative).ToArray();
+
+            var responses = new byte[calls.Count][];
+            var capacity = 4096;
+
+            // The server stops at the first native of which the response does not fit; invoke the remaining natives again.
+            for (var done = 0; done < calls.Count;)
+            {
+                var data = calls.Skip(done).SelectMany(call => ValueConverter.GetBytes(call.Length).Concat(call)).ToArray();
+                var inbuf = Marshal.AllocHGlobal(data.Length);
+                var outbuf = Marshal.AllocHGlobal(capacity);
+                var outlen = capacity;
+                Marshal.Copy(data, 0, inbuf, data.Length);
+
+                Api.InvokeBatch(inbuf, data.Length, outbuf, ref outlen);
+
+                var outarr = new byte[outlen];
+                Marshal.Copy(outbuf, outarr, 0, outlen);
+
+                Marshal.FreeHGlobal(inbuf);
+                Marshal.FreeHGlobal(outbuf);
+
+                var count = outlen < 4 ? 0 : ValueConverter.ToInt32(outarr, 0);
+                for (int i = 0, position = 4; i < count; i++)
+                {
+                    var length = ValueConverter.ToInt32(outarr, position);
+                    position += 4;
+
+                    var response = new byte[length];
+                    Array.Copy(outarr, position, response, 0, length);
+                    responses[done + i] = response;
+                    position += length;
+                }
+
+                if (count == 0)
+                {
+                    if (capacity >= MaxBatchResponseSize)
+                        throw new GameModeClientException("The natives could not be invoked.");
+
+                    capacity *= 2;
+                }
+
+                done += count;
+            }
+
+            return responses;
+        }
+
+        /// <summary>
+        ///     Queues a sequence of natives using the specified <paramref name="calls" /> buffers to be invoked during the next
+        ///     tick. Does not wait for the natives to be invoked; their responses are discarded.
+        /// </summary>
+        /// <param name="calls">The data buffers of the natives to invoke.</param>
+        public void QueueNatives(IList<byte[]> calls)
+        {
+            if (calls == null) throw new ArgumentNullException(nameof(calls));
+
+            if (Api?.QueueBatch == null)
+            {
+                _syncronizationContext.Post(ctx => InvokeNatives(calls), null);
+                return;
+            }
+
+            var data = calls.SelectMany(call => ValueConverter.GetBytes(call.Length).Concat(call)).ToArray();
+            var inbuf = Marshal.AllocHGlobal(data.Length);
+            Marshal.Copy(data, 0, inbuf, data.Length);
+
+            Api.QueueBatch(inbuf, data.Length);
+
+            Marshal.FreeHGlobal(inbuf);
+        }
+
+        /// <summary>
+        ///     Sets the policy the server uses to cache the results of the native with the specified <paramref name="handle" />.
+        /// </summary>
+        /// <param name="handle">The handle of the native.</param>
+        /// <param name="policy">The caching policy.</param>
+        /// <param name="timeToLive">The number of milliseconds results are valid if the policy is <see cref="NativeCachePolicy.TimeToLive" />.</param>
+        public void SetNativeCachePolicy(int handle, NativeCachePolicy policy, int timeToLive = 0)
+        {
+            if (IsOnMainThread)
+                Interop.SetNativeCache(handle, (int) policy, timeToLive);
+            else
+                _syncronizationContext.Send(ctx => Interop.SetNativeCache(handle, (int) policy, timeToLive), null);
+        }
+
+        /// <summary>
+        ///     Gets the snapshot of player and vehicle state gathered by the server every tick.
+        /// </summary>
+        public EntitySnapshot Snapshot { get; } = new EntitySnapshot();
+
+        /// <summary>
+        ///     Gets a value indicating whether the callback being handled is a dry run sent by the server to warm up the
+        ///     game mode before players join. Handlers should skip side effects during dry runs.
+        /// </summary>
+        public bool IsDryRun { get; private set; }
+
+        /// <summary>
+        ///     Sets the attributes the server gathers in the <see cref="Snapshot" /> every tick.
+        /// </summary>
+        /// <param name="attributes">The attributes to gather.</param>
+        public void SetSnapshotAttributes(EntitySnapshotAttributes attributes)
+        {
+            if (IsOnMainThread)
+                AttachSnapshot(attributes);
+            else
+                _syncronizationContext.Send(ctx => AttachSnapshot(attributes), null);
+        }
+
+        private void AttachSnapshot(EntitySnapshotAttributes attributes)
+        {
+            // The snapshot is stored at a fixed address and updated by the server before every tick.
+            Interop.SetSnapshot((uint) attributes, out var data);
+
+            if (data == IntPtr.Zero)
+                Snapshot.Reset();
+            else
+                Snapshot.Attach(data);
+        }
+
         /// <summary>
         ///     Shuts down the server after the current callback has been processed.
         /// </summary>
@@ -0,0 +1,132 @@
+﻿// SampSharp
+// Copyright 2018 Tim Potze
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+using System;
+using System.Runtime.InteropServices;
+
+namespace SampSharp.Core.Hosting
+{
+    /// <summary>
+    ///     Represents the table of functions handed to a hosted game mode by the server at startup.
+    /// </summary>
+    /// <remarks>
+    ///     The table starts with its version and size, followed by function pointers. Fields are only appended to the table;
+    ///     functions which do not fit the size of the table are not available.
+    /// </remarks>
+    internal sealed class HostedApi
+    {
+        private const int HeaderSize = 8;
+
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        public delegate void PrintFunction(string message);
+
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        public delegate int GetNativeHandleFunction(string name);
+
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        public delegate void InvokeNativeFunction(IntPtr inbuf, int inlen, IntPtr outbuf, ref int outlen);
+
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        public delegate int InvokeValuesFunction(int handle, int[] args, int count);
+
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        public delegate int InvokeIntFloat3Function(int handle, int a, float x, float y, float z);
+
+        [UnmanagedFunctionPointer(CallingConvention.StdCall)]
+        public delegate void QueueBatchFunction(IntPtr inbuf, int inlen);
+
+        private HostedApi(IntPtr pointer)
+        {
+            Version = Marshal.ReadInt32(pointer);
+
+            var size = Marshal.ReadInt32(pointer, 4);
+            var index = 0;
+
+            Print = Read<PrintFunction>(pointer, size, index++);
+            GetNativeHandle = Read<GetNativeHandleFunction>(pointer, size, index++);
+            InvokeNative = Read<InvokeNativeFunction>(pointer, size, index++);
+            InvokeBatch = Read<InvokeNativeFunction>(pointer, size, index++);
+            InvokeValues = Read<InvokeValuesFunction>(pointer, size, index++);
+            InvokeIntFloat3 = Read<InvokeIntFloat3Function>(pointer, size, index++);
+
+            // Functions are at fixed positions in the table; skip the functions the client does not call through the table.
+            index += 5;
+            QueueBatch = Read<QueueBatchFunction>(pointer, size, index);
+        }
+
+        /// <summary>
+        ///     Gets the version of the table.
+        /// </summary>
+        public int Version { get; }
+
+        /// <summary>
+        ///     Gets the function which prints a message to the server console.
+        /// </summary>
+        public PrintFunction Print { get; }
+
+        /// <summary>
+        ///     Gets the function which finds the handle of a native.
+        /// </summary>
+        public GetNativeHandleFunction GetNativeHandle { get; }
+
+        /// <summary>
+        ///     Gets the function which invokes a native using a serialized call.
+        /// </summary>
+        public InvokeNativeFunction InvokeNative { get; }
+
+        /// <summary>
+        ///     Gets the function which invokes a sequence of serialized calls.
+        /// </summary>
+        public InvokeNativeFunction InvokeBatch { get; }
+
+        /// <summary>
+        ///     Gets the function which invokes a native taking only value arguments.
+        /// </summary>
+        public InvokeValuesFunction InvokeValues { get; }
+
+        /// <summary>
+        ///     Gets the function which invokes a native taking an integer and three floats.
+        /// </summary>
+        public InvokeIntFloat3Function InvokeIntFloat3 { get; }
+
+        /// <summary>
+        ///     Gets the function which queues a sequence of serialized calls to be invoked during the next tick.
+        /// </summary>
+        public QueueBatchFunction QueueBatch { get; }
+
+        /// <summary>
+        ///     Binds to the table at the specified <paramref name="pointer" />.
+        /// </summary>
+        /// <param name="pointer">The pointer to the table.</param>
+        /// <returns>The bound table or <c>null</c> if no table was handed to the game mode.</returns>
+        public static HostedApi Bind(IntPtr pointer)
+        {
+            return pointer == IntPtr.Zero ? null : new HostedApi(pointer);
+        }
+
+        private static T Read<T>(IntPtr pointer, int size, int index) where T : class
+        {
+            var offset = HeaderSize + index * IntPtr.Size;
+
+            if (offset + IntPtr.Size > size)
+                return null;
+
+            var function = Marshal.ReadIntPtr(pointer, offset);
+
+            return function == IntPtr.Zero ? null : Marshal.GetDelegateForFunctionPointer<T>(function);
+        }
+    }
+}
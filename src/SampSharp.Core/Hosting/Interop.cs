@@ -15,7 +15,11 @@
 
 using System;
 using System.Diagnostics.CodeAnalysis;
+using System.IO;
+using System.Linq;
+using System.Reflection;
 using System.Runtime.InteropServices;
+using SampSharp.Core.Logging;
 
 namespace SampSharp.Core.Hosting
 {
@@ -28,12 +32,73 @@ namespace SampSharp.Core.Hosting
         [DllImport("SampSharp", EntryPoint = "sampsharp_register_callback", CallingConvention = CallingConvention.StdCall)]
         public static extern void RegisterCallback(IntPtr data);
 
+        [DllImport("SampSharp", EntryPoint = "sampsharp_register_callback_id", CallingConvention = CallingConvention.StdCall)]
+        public static extern void RegisterCallback(IntPtr data, out int id);
+
+        [DllImport("SampSharp", EntryPoint = "sampsharp_register_filter", CallingConvention = CallingConvention.StdCall)]
+        public static extern void RegisterFilter(IntPtr data, int length);
+
         [DllImport("SampSharp", EntryPoint = "sampsharp_get_native_handle", CallingConvention = CallingConvention.StdCall)]
         public static extern int GetNativeHandle(string name);
 
         [DllImport("SampSharp", EntryPoint = "sampsharp_invoke_native", CallingConvention = CallingConvention.StdCall)]
         public static extern void InvokeNative(IntPtr inbuf, int inlen, IntPtr outbuf, ref int outlen);
 
+        [DllImport("SampSharp", EntryPoint = "sampsharp_set_native_cache", CallingConvention = CallingConvention.StdCall)]
+        public static extern void SetNativeCache(int handle, int policy, int ttl);
+
+        [DllImport("SampSharp", EntryPoint = "sampsharp_set_snapshot", CallingConvention = CallingConvention.StdCall)]
+        public static extern void SetSnapshot(uint attributes, out IntPtr data);
+
+        [DllImport("SampSharp", EntryPoint = "sampsharp_query_radius", CallingConvention = CallingConvention.StdCall)]
+        public static extern void QueryRadius(uint kinds, float x, float y, float z, float radius, [Out] int[] ids, ref int count);
+
+        [DllImport("SampSharp", EntryPoint = "sampsharp_get_amx_address", CallingConvention = CallingConvention.StdCall)]
+        public static extern void GetAmxAddress(IntPtr amx, int address, out IntPtr ptr);
+
+        [DllImport("SampSharp", EntryPoint = "sampsharp_get_amx_string", CallingConvention = CallingConvention.StdCall)]
+        public static extern void GetAmxString(IntPtr amx, int address, [Out] byte[] buffer, ref int length);
+
+        // Hosts which create function pointers through hostfxr use the delegate types nested in this class.
+        public delegate int ExecuteDelegate(IntPtr argv, int argc);
+        public delegate int PublicCallDelegate(string name, IntPtr argumentsPtr, int length);
+        public delegate int DirectCallDelegate(int id, IntPtr amx, IntPtr parameters);
+        public delegate int DryRunCallDelegate(int id, IntPtr amx, IntPtr parameters);
+        public delegate void RestartDelegate();
+        public delegate void TickDelegate();
+
+        public static int Execute(IntPtr argv, int argc)
+        {
+            var args = new string[argc];
+            for (var i = 0; i < argc; i++)
+                args[i] = Marshal.PtrToStringAnsi(Marshal.ReadIntPtr(argv, i * IntPtr.Size));
+
+            try
+            {
+                // The first argument is the path of the game mode assembly. The host has loaded it in the load context
+                // of this assembly.
+                var assembly = Assembly.Load(new AssemblyName(Path.GetFileNameWithoutExtension(args[0])));
+                var entryPoint = assembly.GetType().GetRuntimeProperty("EntryPoint")?.GetValue(assembly) as MethodInfo;
+
+                if (entryPoint == null)
+                {
+                    CoreLog.Log(CoreLogLevel.Error, $"The game mode assembly {args[0]} has no entry point.");
+                    return 1;
+                }
+
+                var parameters = entryPoint.GetParameters().Length == 0
+                    ? null
+                    : new object[] { args.Skip(1).ToArray() };
+
+                return entryPoint.Invoke(null, parameters) is int exitCode ? exitCode : 0;
+            }
+            catch (Exception e)
+            {
+                CoreLog.Log(CoreLogLevel.Error, $"Failed to run the game mode: {e}");
+                return 1;
+            }
+        }
+
         public static int PublicCall(string name, IntPtr argumentsPtr, int length)
         {
             var client = InternalStorage.RunningClient as HostedGameModeClient;
@@ -41,6 +106,27 @@ namespace SampSharp.Core.Hosting
             return client?.PublicCall(name, argumentsPtr, length) ?? 1;
         }
 
+        public static int DirectCall(int id, IntPtr amx, IntPtr parameters)
+        {
+            var client = InternalStorage.RunningClient as HostedGameModeClient;
+
+            return client?.DirectCall(id, amx, parameters) ?? 1;
+        }
+
+        public static int DryRunCall(int id, IntPtr amx, IntPtr parameters)
+        {
+            var client = InternalStorage.RunningClient as HostedGameModeClient;
+
+            return client?.DryRunCall(id, amx, parameters) ?? 1;
+        }
+
+        public static void Restart()
+        {
+            var client = InternalStorage.RunningClient as HostedGameModeClient;
+
+            client?.Restart();
+        }
+
         public static void Tick()
         {
             var client = InternalStorage.RunningClient as HostedGameModeClient;
@@ -59,6 +59,14 @@ namespace SampSharp.Core
         /// <param name="parameters">The parameters of the callback.</param>
         void RegisterCallback(string name, object target, MethodInfo methodInfo, CallbackParameterInfo[] parameters);
         
+        /// <summary>
+        ///     Sets the filter the server evaluates before forwarding calls to the callback with the specified
+        ///     <paramref name="name" />. Calls which do not pass the filter are not sent to the game mode.
+        /// </summary>
+        /// <param name="name">The name of the callback.</param>
+        /// <param name="filter">The filter or <c>null</c> to remove the filter.</param>
+        void SetCallbackFilter(string name, CallbackFilter filter);
+
         /// <summary>
         ///     Prints the specified text to the server console.
         /// </summary>
@@ -79,6 +87,43 @@ namespace SampSharp.Core
         /// <returns>The response from the native.</returns>
         byte[] InvokeNative(IEnumerable<byte> data);
 
+        /// <summary>
+        ///     Sets the policy the server uses to cache the results of the native with the specified <paramref name="handle" />.
+        /// </summary>
+        /// <param name="handle">The handle of the native.</param>
+        /// <param name="policy">The caching policy.</param>
+        /// <param name="timeToLive">The number of milliseconds results are valid if the policy is <see cref="NativeCachePolicy.TimeToLive" />.</param>
+        void SetNativeCachePolicy(int handle, NativeCachePolicy policy, int timeToLive = 0);
+
+        /// <summary>
+        ///     Gets the snapshot of player and vehicle state gathered by the server every tick.
+        /// </summary>
+        EntitySnapshot Snapshot { get; }
+
+        /// <summary>
+        ///     Gets a value indicating whether the callback being handled is a dry run sent by the server to warm up the
+        ///     game mode before players join. Handlers should skip side effects during dry runs.
+        /// </summary>
+        bool IsDryRun { get; }
+
+        /// <summary>
+        ///     Sets the attributes the server gathers in the <see cref="Snapshot" /> every tick.
+        /// </summary>
+        /// <param name="attributes">The attributes to gather.</param>
+        void SetSnapshotAttributes(EntitySnapshotAttributes attributes);
+
+        /// <summary>
+        ///     Finds the entities within the specified <paramref name="radius" /> of a point. Positions are indexed by the
+        ///     server once per tick.
+        /// </summary>
+        /// <param name="targets">The kinds of entities to find.</param>
+        /// <param name="x">The x-coordinate of the point.</param>
+        /// <param name="y">The y-coordinate of the point.</param>
+        /// <param name="z">The z-coordinate of the point.</param>
+        /// <param name="radius">The radius.</param>
+        /// <returns>The identifiers of the entities found.</returns>
+        int[] QueryRadius(SpatialQueryTargets targets, float x, float y, float z, float radius);
+
 
         /// <summary>
         ///     Shuts down the server after the current callback has been processed.
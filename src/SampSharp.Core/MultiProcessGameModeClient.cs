@@ -38,6 +38,17 @@ namespace SampSharp.Core
         private static readonly byte[] AOne = { 1 };
         private static readonly byte[] AZero = { 0 };
 
+        /// <summary>
+        ///     The capabilities supported by this client.
+        /// </summary>
+        private const ServerCapabilities SupportedCapabilities =
+            ServerCapabilities.ChunkedFrames | ServerCapabilities.DryRunCalls;
+
+        /// <summary>
+        ///     The maximum size of frames sent by the server before they are split into chunks.
+        /// </summary>
+        private const uint MaxFrameSize = 1024 * 32;
+
         private readonly Dictionary<string, Callback> _callbacks = new Dictionary<string, Callback>();
         private readonly CommandWaitQueue _commandWaitQueue = new CommandWaitQueue();
         private readonly IGameModeProvider _gameModeProvider;
@@ -52,6 +63,7 @@ namespace SampSharp.Core
         private SampSharpSyncronizationContext _syncronizationContext;
         private DateTime _lastSend;
         private ushort _callerIndex;
+        private bool _announcedCapabilities;
 
         /// <summary>
         ///     Initializes a new instance of the <see cref="MultiProcessGameModeClient" /> class.
@@ -94,6 +106,9 @@ namespace SampSharp.Core
                     if (DateTime.UtcNow - _lastSend > TimeSpan.FromSeconds(3))
                         Send(ServerCommand.Alive, null);
 
+                    break;
+                case ServerCommand.SnapshotFrame:
+                    Snapshot.Apply(data.Data);
                     break;
                 case ServerCommand.Pong:
                     if (_pongs.Count == 0)
@@ -108,6 +123,32 @@ namespace SampSharp.Core
                     CoreLog.Log(CoreLogLevel.Error, "Received a random server announcement");
                     CoreLog.Log(CoreLogLevel.Debug, Environment.StackTrace);
                     break;
+                case ServerCommand.DryRunCall:
+                    var dryRunName = ValueConverter.ToString(data.Data, 0, Encoding);
+                    int? dryRunResult = null;
+
+                    if (_callbacks.TryGetValue(dryRunName, out var dryRunCallback))
+                    {
+                        IsDryRun = true;
+                        try
+                        {
+                            dryRunResult = dryRunCallback.Invoke(data.Data, dryRunName.Length + 1);
+                        }
+                        catch (Exception e)
+                        {
+                            OnUnhandledException(new UnhandledExceptionEventArgs(e));
+                        }
+                        finally
+                        {
+                            IsDryRun = false;
+                        }
+                    }
+
+                    Send(ServerCommand.Response,
+                        dryRunResult != null
+                            ? AOne.Concat(ValueConverter.GetBytes(dryRunResult.Value))
+                            : AZero);
+                    break;
                 case ServerCommand.PublicCall:
                     var name = ValueConverter.ToString(data.Data, 0, Encoding);
                     var isInit = name == "OnGameModeInit";
@@ -267,6 +308,19 @@ namespace SampSharp.Core
                 
                 ServerPath = ValueConverter.ToString(data.Data, 8, Encoding.ASCII);
 
+                // Servers supporting capability negotiation append their capabilities after the server path.
+                var capabilitiesIndex = Array.IndexOf(data.Data, (byte) '\0', 8) + 1;
+                _announcedCapabilities = capabilitiesIndex > 0 && data.Data.Length >= capabilitiesIndex + 12;
+                Capabilities = ServerCapabilities.None;
+
+                if (_announcedCapabilities)
+                {
+                    var serverCapabilities = (ServerCapabilities) ValueConverter.ToUInt32(data.Data, capabilitiesIndex);
+
+                    Capabilities = serverCapabilities & SupportedCapabilities;
+                    CoreLog.Log(CoreLogLevel.Debug, $"Server capabilities: {serverCapabilities}, accepted: {Capabilities}");
+                }
+
                 return true;
             }
             CoreLog.Log(CoreLogLevel.Error, $"Received command {data.Command.ToString().ToLower()} instead of announce.");
@@ -302,6 +356,14 @@ namespace SampSharp.Core
             if (!VerifyVersionData(data))
                 return;
 
+            if (_announcedCapabilities)
+            {
+                CoreLog.Log(CoreLogLevel.Info, "Sending accepted capabilities to server...");
+                Send(ServerCommand.Capabilities, ValueConverter.GetBytes((uint) Capabilities)
+                    .Concat(ValueConverter.GetBytes(MaxFrameSize))
+                    .Concat(ValueConverter.GetBytes(0u)));
+            }
+
             CoreLog.Log(CoreLogLevel.Info, "Initializing game mode provider...");
             _gameModeProvider.Initialize(this);
 
@@ -464,6 +526,11 @@ namespace SampSharp.Core
         /// </summary>
         public ICommunicationClient CommunicationClient { get; }
 
+        /// <summary>
+        ///     Gets the capabilities negotiated with the server.
+        /// </summary>
+        public ServerCapabilities Capabilities { get; private set; }
+
         #region Implementation of IGameModeClient
 
         /// <summary>
@@ -507,6 +574,21 @@ namespace SampSharp.Core
                 .Concat(new[] { (byte) ServerCommandArgument.Terminator }));
         }
         
+        /// <summary>
+        ///     Sets the filter the server evaluates before forwarding calls to the callback with the specified
+        ///     <paramref name="name" />. Calls which do not pass the filter are not sent to the game mode.
+        /// </summary>
+        /// <param name="name">The name of the callback.</param>
+        /// <param name="filter">The filter or <c>null</c> to remove the filter.</param>
+        public void SetCallbackFilter(string name, CallbackFilter filter)
+        {
+            if (name == null) throw new ArgumentNullException(nameof(name));
+
+            AssertRunning();
+
+            SendOnMainThread(ServerCommand.CallbackFilter, (filter ?? new CallbackFilter()).GetBytes(name, Encoding));
+        }
+
         /// <summary>
         ///     Prints the specified text to the server console.
         /// </summary>
@@ -540,6 +622,40 @@ namespace SampSharp.Core
             return ValueConverter.ToInt32(data.Data, 2);
         }
 
+        /// <summary>
+        ///     Finds the entities within the specified <paramref name="radius" /> of a point. Positions are indexed by the
+        ///     server once per tick.
+        /// </summary>
+        /// <param name="targets">The kinds of entities to find.</param>
+        /// <param name="x">The x-coordinate of the point.</param>
+        /// <param name="y">The y-coordinate of the point.</param>
+        /// <param name="z">The z-coordinate of the point.</param>
+        /// <param name="radius">The radius.</param>
+        /// <returns>The identifiers of the entities found.</returns>
+        public int[] QueryRadius(SpatialQueryTargets targets, float x, float y, float z, float radius)
+        {
+            var caller = GetCallerId();
+            var data = SendAndWaitOnMainThread(ServerCommand.QueryRadius,
+                ValueConverter.GetBytes(caller)
+                    .Concat(ValueConverter.GetBytes((uint) targets))
+                    .Concat(ValueConverter.GetBytes(x))
+                    .Concat(ValueConverter.GetBytes(y))
+                    .Concat(ValueConverter.GetBytes(z))
+                    .Concat(ValueConverter.GetBytes(radius)),
+                d => d.Command != ServerCommand.Response || (d.Data != null && d.Data.Length >= 2 && ValueConverter.ToUInt16(d.Data, 0) == caller));
+
+            if (data.Data.Length < 6)
+                throw new Exception("Invalid QueryRadius response from server.");
+
+            var count = ValueConverter.ToInt32(data.Data, 2);
+            if (data.Data.Length != 6 + count * 4)
+                throw new Exception("Invalid QueryRadius response from server.");
+
+            var result = new int[count];
+            Buffer.BlockCopy(data.Data, 6, result, 0, count * 4);
+            return result;
+        }
+
         /// <summary>
         ///     Invokes a native using the specified <paramref name="data" /> buffer.
         /// </summary>
@@ -557,6 +673,50 @@ namespace SampSharp.Core
             return response.Data.Skip(2).ToArray(); // TODO: Optimize GC allocations
         }
 
+        /// <summary>
+        ///     Sets the policy the server uses to cache the results of the native with the specified <paramref name="handle" />.
+        /// </summary>
+        /// <param name="handle">The handle of the native.</param>
+        /// <param name="policy">The caching policy.</param>
+        /// <param name="timeToLive">The number of milliseconds results are valid if the policy is <see cref="NativeCachePolicy.TimeToLive" />.</param>
+        public void SetNativeCachePolicy(int handle, NativeCachePolicy policy, int timeToLive = 0)
+        {
+            AssertRunning();
+
+            SendOnMainThread(ServerCommand.NativeCache, ValueConverter.GetBytes(handle)
+                .Concat(ValueConverter.GetBytes((int) policy))
+                .Concat(ValueConverter.GetBytes(timeToLive)));
+        }
+
+        /// <summary>
+        ///     Gets the snapshot of player and vehicle state gathered by the server every tick.
+        /// </summary>
+        public EntitySnapshot Snapshot { get; } = new EntitySnapshot();
+
+        /// <summary>
+        ///     Gets a value indicating whether the callback being handled is a dry run sent by the server to warm up the
+        ///     game mode before players join. Handlers should skip side effects during dry runs.
+        /// </summary>
+        public bool IsDryRun { get; private set; }
+
+        /// <summary>
+        ///     Sets the attributes the server gathers in the <see cref="Snapshot" /> every tick.
+        /// </summary>
+        /// <param name="attributes">The attributes to gather.</param>
+        public void SetSnapshotAttributes(EntitySnapshotAttributes attributes)
+        {
+            AssertRunning();
+
+            // A keyframe can be larger than the maximum frame size.
+            if (attributes != EntitySnapshotAttributes.None && !Capabilities.HasFlag(ServerCapabilities.ChunkedFrames))
+                throw new GameModeClientException("Entity snapshots require a server which supports chunked frames.");
+
+            SendOnMainThread(ServerCommand.Snapshot, ValueConverter.GetBytes((uint) attributes));
+
+            // The server sends a keyframe before the next tick.
+            Snapshot.Reset();
+        }
+
         /// <summary>
         ///     Shuts down the server after the current callback has been processed.
         /// </summary>
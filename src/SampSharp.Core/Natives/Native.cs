@@ -27,6 +27,15 @@ namespace SampSharp.Core.Natives
     public class Native : INative
     {
         private readonly IGameModeClient _gameModeClient;
+        private const int MaxScratchValues = 32;
+
+        private readonly HostedGameModeClient _hostedClient;
+        private readonly bool _valuesOnly;
+        private readonly bool _intFloat3;
+
+        // Natives may be invoked from multiple threads; each thread reuses its own value buffers, indexed by the number
+        // of parameters.
+        [ThreadStatic] private static int[][] _scratchValues;
 
         /// <summary>
         ///     Initializes a new instance of the <see cref="Native" /> class.
@@ -46,6 +55,16 @@ namespace SampSharp.Core.Natives
 
             if (parameters.Any(info => info.RequiresLength && info.LengthIndex >= parameters.Length))
                 throw new ArgumentOutOfRangeException(nameof(parameters), "Invalid parameter length index.");
+
+            // Natives taking only values can be invoked by hosted game modes without serializing the call.
+            _hostedClient = gameModeClient as HostedGameModeClient;
+            if (_hostedClient != null && parameters.All(info => info.Type == NativeParameterType.Int32 ||
+                                                                info.Type == NativeParameterType.Single ||
+                                                                info.Type == NativeParameterType.Bool))
+                _valuesOnly = true;
+
+            _intFloat3 = _valuesOnly && parameters.Length == 4 && parameters[0].Type == NativeParameterType.Int32 &&
+                         parameters.Skip(1).All(info => info.Type == NativeParameterType.Single);
         }
 
         #region Implementation of INative
@@ -65,6 +84,16 @@ namespace SampSharp.Core.Natives
         /// </summary>
         public NativeParameterInfo[] Parameters { get; }
 
+        /// <summary>
+        ///     Gets a value indicating whether this native is invoked with its values, without serializing the call.
+        /// </summary>
+        internal bool IsValuesOnly => _valuesOnly;
+
+        /// <summary>
+        ///     Gets a value indicating whether this native is invoked through the int and three floats path.
+        /// </summary>
+        internal bool IsIntFloat3 => _intFloat3;
+
         /// <summary>
         ///     Invokes the native with the specified arguments.
         /// </summary>
@@ -77,11 +106,23 @@ namespace SampSharp.Core.Natives
             if (Parameters.Length != arguments.Length)
                 throw new ArgumentOutOfRangeException(nameof(arguments), "Invalid argument count");
             
-            IEnumerable<byte> data = ValueConverter.GetBytes(Handle);
-
             if (CoreLog.DoesLog(CoreLogLevel.Verbose))
                 CoreLog.LogVerbose("Invoking {0}({1})", Name, string.Join(", ", arguments));
 
+            if (_intFloat3 && arguments[0] is int a && arguments[1] is float x && arguments[2] is float y && arguments[3] is float z &&
+                _hostedClient.TryInvokeIntFloat3(Handle, a, x, y, z, out var result))
+                return result;
+
+            if (_valuesOnly)
+            {
+                var values = GetScratchValues(Parameters.Length);
+
+                if (TryGetValues(arguments, values) && _hostedClient.TryInvokeValues(Handle, values, out result))
+                    return result;
+            }
+
+            IEnumerable<byte> data = ValueConverter.GetBytes(Handle);
+
             int length;
 
             for (var i = 0; i < Parameters.Length; i++)
@@ -114,6 +155,39 @@ namespace SampSharp.Core.Natives
             return ValueConverter.ToInt32(response, 0);
         }
 
+        internal static int[] GetScratchValues(int length)
+        {
+            if (length > MaxScratchValues)
+                return new int[length];
+
+            var scratch = _scratchValues ?? (_scratchValues = new int[MaxScratchValues + 1][]);
+
+            return scratch[length] ?? (scratch[length] = new int[length]);
+        }
+
+        internal bool TryGetValues(object[] arguments, int[] values)
+        {
+            for (var i = 0; i < arguments.Length; i++)
+            {
+                switch (arguments[i])
+                {
+                    case int v when Parameters[i].Type == NativeParameterType.Int32:
+                        values[i] = v;
+                        break;
+                    case float f when Parameters[i].Type == NativeParameterType.Single:
+                        values[i] = ValueConverter.ToInt32(f);
+                        break;
+                    case bool b when Parameters[i].Type == NativeParameterType.Bool:
+                        values[i] = ValueConverter.ToInt32(b);
+                        break;
+                    default:
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
         private int GetLength(int parameterIndex, object[] arguments)
         {
             if (!Parameters[parameterIndex].RequiresLength)
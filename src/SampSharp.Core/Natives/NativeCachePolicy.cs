@@ -0,0 +1,44 @@
+﻿// SampSharp
+// Copyright 2018 Tim Potze
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+namespace SampSharp.Core.Natives
+{
+    /// <summary>
+    ///     Contains the policies the server can use to cache the results of a native.
+    /// </summary>
+    public enum NativeCachePolicy
+    {
+        /// <summary>
+        ///     The native is invoked every time.
+        /// </summary>
+        None = 0,
+
+        /// <summary>
+        ///     The results of the native never change for the same arguments.
+        /// </summary>
+        Permanent = 1,
+
+        /// <summary>
+        ///     The results of the native are valid until the next server tick.
+        /// </summary>
+        Tick = 2,
+
+        /// <summary>
+        ///     The results of the native are valid for a specified number of milliseconds.
+        /// </summary>
+        TimeToLive = 3
+    }
+}
@@ -0,0 +1,41 @@
+﻿// SampSharp
+// Copyright 2018 Tim Potze
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+using System;
+
+namespace SampSharp.Core
+{
+    /// <summary>
+    ///     Contains the kinds of entities which can be found using a radius query.
+    /// </summary>
+    [Flags]
+    public enum SpatialQueryTargets : uint
+    {
+        /// <summary>
+        ///     No entities.
+        /// </summary>
+        None = 0,
+
+        /// <summary>
+        ///     Connected players.
+        /// </summary>
+        Players = 1 << 0,
+
+        /// <summary>
+        ///     Existing vehicles.
+        /// </summary>
+        Vehicles = 1 << 1
+    }
+}
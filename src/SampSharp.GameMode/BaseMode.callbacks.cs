@@ -23,6 +23,13 @@ namespace SampSharp.GameMode
 {
     public abstract partial class BaseMode
     {
+        /// <summary>
+        ///     Gets a value indicating whether the callback being handled is a dry run sent by the server to warm up the
+        ///     game mode. The callbacks of the framework skip dry runs, so no entities are created and no events are
+        ///     raised for them.
+        /// </summary>
+        private bool IsDryRun => Client?.IsDryRun == true;
+
         [Callback]
         internal bool OnGameModeInit()
         {
@@ -42,6 +49,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerConnect(int playerid)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerConnected(BasePlayer.FindOrCreate(playerid), EventArgs.Empty);
 
             return true;
@@ -50,6 +60,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerDisconnect(int playerid, int reason)
         {
+            if (IsDryRun)
+                return true;
+
             var args = new DisconnectEventArgs((DisconnectReason) reason);
 
             OnPlayerDisconnected(BasePlayer.FindOrCreate(playerid), args);
@@ -61,6 +74,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerSpawn(int playerid)
         {
+            if (IsDryRun)
+                return true;
+
             var args = new SpawnEventArgs();
 
             OnPlayerSpawned(BasePlayer.FindOrCreate(playerid), args);
@@ -71,6 +87,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerDeath(int playerid, int killerid, int reason)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerDied(BasePlayer.FindOrCreate(playerid),
                 new DeathEventArgs(killerid == BasePlayer.InvalidId ? null : BasePlayer.FindOrCreate(killerid),
                     (WeaponType) reason));
@@ -81,6 +100,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnVehicleSpawn(int vehicleid)
         {
+            if (IsDryRun)
+                return true;
+
             var vehicle = BaseVehicle.Find(vehicleid);
 
             if (vehicle == null)
@@ -94,6 +116,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnVehicleDeath(int vehicleid, int killerid)
         {
+            if (IsDryRun)
+                return true;
+
             var vehicle = BaseVehicle.Find(vehicleid);
 
             if (vehicle == null)
@@ -107,6 +132,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerText(int playerid, string text)
         {
+            if (IsDryRun)
+                return true;
+
             var args = new TextEventArgs(text);
 
             OnPlayerText(BasePlayer.FindOrCreate(playerid), args);
@@ -117,6 +145,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerCommandText(int playerid, string cmdtext)
         {
+            if (IsDryRun)
+                return true;
+
             var args = new CommandTextEventArgs(cmdtext);
 
             OnPlayerCommandText(BasePlayer.FindOrCreate(playerid), args);
@@ -127,6 +158,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerRequestClass(int playerid, int classid)
         {
+            if (IsDryRun)
+                return true;
+
             var args = new RequestClassEventArgs(classid);
 
             OnPlayerRequestClass(BasePlayer.FindOrCreate(playerid), args);
@@ -137,6 +171,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerEnterVehicle(int playerid, int vehicleid, bool ispassenger)
         {
+            if (IsDryRun)
+                return true;
+
             var vehicle = BaseVehicle.Find(vehicleid);
 
             if (vehicle == null)
@@ -151,6 +188,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerExitVehicle(int playerid, int vehicleid)
         {
+            if (IsDryRun)
+                return true;
+
             var vehicle = BaseVehicle.Find(vehicleid);
 
             if (vehicle == null)
@@ -165,6 +205,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerStateChange(int playerid, int newstate, int oldstate)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerStateChanged(BasePlayer.FindOrCreate(playerid),
                 new StateEventArgs((PlayerState) newstate, (PlayerState) oldstate));
 
@@ -174,6 +217,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerEnterCheckpoint(int playerid)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerEnterCheckpoint(BasePlayer.FindOrCreate(playerid), EventArgs.Empty);
 
             return true;
@@ -182,6 +228,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerLeaveCheckpoint(int playerid)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerLeaveCheckpoint(BasePlayer.FindOrCreate(playerid), EventArgs.Empty);
 
             return true;
@@ -190,6 +239,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerEnterRaceCheckpoint(int playerid)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerEnterRaceCheckpoint(BasePlayer.FindOrCreate(playerid), EventArgs.Empty);
 
             return true;
@@ -198,6 +250,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerLeaveRaceCheckpoint(int playerid)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerLeaveRaceCheckpoint(BasePlayer.FindOrCreate(playerid), EventArgs.Empty);
 
             return true;
@@ -206,6 +261,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnRconCommand(string command)
         {
+            if (IsDryRun)
+                return true;
+
             var args = new RconEventArgs(command);
             OnRconCommand(args);
 
@@ -215,6 +273,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerRequestSpawn(int playerid)
         {
+            if (IsDryRun)
+                return true;
+
             var args = new RequestSpawnEventArgs();
 
             OnPlayerRequestSpawn(BasePlayer.FindOrCreate(playerid), args);
@@ -225,6 +286,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnObjectMoved(int objectid)
         {
+            if (IsDryRun)
+                return true;
+
             var @object = GlobalObject.Find(objectid);
 
             if (@object == null)
@@ -238,6 +302,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerObjectMoved(int playerid, int objectid)
         {
+            if (IsDryRun)
+                return true;
+
             var @object = PlayerObject.Find(BasePlayer.FindOrCreate(playerid), objectid);
 
             if (@object == null)
@@ -251,6 +318,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerPickUpPickup(int playerid, int pickupid)
         {
+            if (IsDryRun)
+                return true;
+
             var pickup = Pickup.Find(pickupid);
 
             if (pickup == null)
@@ -264,6 +334,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnVehicleMod(int playerid, int vehicleid, int componentid)
         {
+            if (IsDryRun)
+                return true;
+
             var vehicle = BaseVehicle.Find(vehicleid);
 
             if (vehicle == null)
@@ -279,6 +352,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnEnterExitModShop(int playerid, int enterexit, int interiorid)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerEnterExitModShop(BasePlayer.FindOrCreate(playerid),
                 new EnterModShopEventArgs((EnterExit) enterexit, interiorid));
 
@@ -288,6 +364,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnVehiclePaintjob(int playerid, int vehicleid, int paintjobid)
         {
+            if (IsDryRun)
+                return true;
+
             var vehicle = BaseVehicle.Find(vehicleid);
 
             if (vehicle == null)
@@ -303,6 +382,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnVehicleRespray(int playerid, int vehicleid, int color1, int color2)
         {
+            if (IsDryRun)
+                return true;
+
             var vehicle = BaseVehicle.Find(vehicleid);
 
             if (vehicle == null)
@@ -316,6 +398,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnVehicleDamageStatusUpdate(int vehicleid, int playerid)
         {
+            if (IsDryRun)
+                return true;
+
             var vehicle = BaseVehicle.Find(vehicleid);
 
             if (vehicle == null)
@@ -330,6 +415,9 @@ namespace SampSharp.GameMode
         internal bool OnUnoccupiedVehicleUpdate(int vehicleid, int playerid, int passengerSeat, float newX,
             float newY, float newZ, float velX, float velY, float velZ)
         {
+            if (IsDryRun)
+                return true;
+
             var vehicle = BaseVehicle.Find(vehicleid);
 
             if (vehicle == null)
@@ -345,6 +433,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerSelectedMenuRow(int playerid, int row)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerSelectedMenuRow(BasePlayer.FindOrCreate(playerid), new MenuRowEventArgs(row));
 
             return true;
@@ -353,6 +444,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerExitedMenu(int playerid)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerExitedMenu(BasePlayer.FindOrCreate(playerid), EventArgs.Empty);
 
             return true;
@@ -361,6 +455,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerInteriorChange(int playerid, int newinteriorid, int oldinteriorid)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerInteriorChanged(BasePlayer.FindOrCreate(playerid),
                 new InteriorChangedEventArgs(newinteriorid, oldinteriorid));
 
@@ -370,6 +467,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerKeyStateChange(int playerid, int newkeys, int oldkeys)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerKeyStateChanged(BasePlayer.FindOrCreate(playerid),
                 new KeyStateChangedEventArgs((Keys) newkeys, (Keys) oldkeys));
 
@@ -379,6 +479,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnRconLoginAttempt(string ip, string password, bool success)
         {
+            if (IsDryRun)
+                return true;
+
             OnRconLoginAttempt(new RconLoginAttemptEventArgs(ip, password, success));
 
             return true;
@@ -387,6 +490,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerUpdate(int playerid)
         {
+            if (IsDryRun)
+                return true;
+
             var args = new PlayerUpdateEventArgs();
 
             OnPlayerUpdate(BasePlayer.FindOrCreate(playerid), args);
@@ -397,6 +503,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerStreamIn(int playerid, int forplayerid)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerStreamIn(BasePlayer.FindOrCreate(playerid),
                 new PlayerEventArgs(BasePlayer.FindOrCreate(forplayerid)));
 
@@ -406,6 +515,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerStreamOut(int playerid, int forplayerid)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerStreamOut(BasePlayer.FindOrCreate(playerid),
                 new PlayerEventArgs(BasePlayer.FindOrCreate(forplayerid)));
 
@@ -415,6 +527,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnVehicleStreamIn(int vehicleid, int forplayerid)
         {
+            if (IsDryRun)
+                return true;
+
             var vehicle = BaseVehicle.Find(vehicleid);
 
             if (vehicle == null)
@@ -428,6 +543,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnVehicleStreamOut(int vehicleid, int forplayerid)
         {
+            if (IsDryRun)
+                return true;
+
             var vehicle = BaseVehicle.Find(vehicleid);
 
             if (vehicle == null)
@@ -441,6 +559,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnTrailerUpdate(int playerId, int vehicleid)
         {
+            if (IsDryRun)
+                return true;
+
             var vehicle = BaseVehicle.Find(vehicleid);
 
             if (vehicle == null)
@@ -455,6 +576,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnDialogResponse(int playerid, int dialogid, int response, int listitem, string inputtext)
         {
+            if (IsDryRun)
+                return true;
+
             OnDialogResponse(BasePlayer.FindOrCreate(playerid),
                 new DialogResponseEventArgs(BasePlayer.FindOrCreate(playerid), dialogid, response, listitem, inputtext));
 
@@ -464,6 +588,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerTakeDamage(int playerid, int issuerid, float amount, int weaponid, int bodypart)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerTakeDamage(BasePlayer.FindOrCreate(playerid),
                 new DamageEventArgs(issuerid == BasePlayer.InvalidId ? null : BasePlayer.FindOrCreate(issuerid),
                     amount, (WeaponType) weaponid, (BodyPart) bodypart));
@@ -474,6 +601,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerGiveDamage(int playerid, int damagedid, float amount, int weaponid, int bodypart)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerGiveDamage(BasePlayer.FindOrCreate(playerid),
                 new DamageEventArgs(damagedid == BasePlayer.InvalidId ? null : BasePlayer.FindOrCreate(damagedid),
                     amount, (WeaponType) weaponid, (BodyPart) bodypart));
@@ -484,6 +614,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerClickMap(int playerid, float fX, float fY, float fZ)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerClickMap(BasePlayer.FindOrCreate(playerid), new PositionEventArgs(new Vector3(fX, fY, fZ)));
 
             return true;
@@ -492,6 +625,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerClickTextDraw(int playerid, int clickedid)
         {
+            if (IsDryRun)
+                return true;
+
             var clicked = clickedid == TextDraw.InvalidId ? null : TextDraw.Find(clickedid);
 
             if (clickedid != TextDraw.InvalidId && clicked == null)
@@ -506,6 +642,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerClickPlayerTextDraw(int playerid, int playertextid)
         {
+            if (IsDryRun)
+                return true;
+
             var player = BasePlayer.FindOrCreate(playerid);
 
             var clicked = playertextid == PlayerTextDraw.InvalidId ? null : PlayerTextDraw.Find(player, playertextid);
@@ -521,6 +660,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerClickPlayer(int playerid, int clickedplayerid, int source)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerClickPlayer(BasePlayer.FindOrCreate(playerid),
                 new ClickPlayerEventArgs(
                     clickedplayerid == BasePlayer.InvalidId ? null : BasePlayer.FindOrCreate(clickedplayerid),
@@ -533,6 +675,9 @@ namespace SampSharp.GameMode
         internal bool OnPlayerEditObject(int playerid, bool playerobject, int objectid, int response, float fX, float fY,
             float fZ, float fRotX, float fRotY, float fRotZ)
         {
+            if (IsDryRun)
+                return true;
+
             var player = BasePlayer.FindOrCreate(playerid);
             if (playerobject)
             {
@@ -565,6 +710,9 @@ namespace SampSharp.GameMode
             float fOffsetX, float fOffsetY, float fOffsetZ, float fRotX, float fRotY, float fRotZ, float fScaleX,
             float fScaleY, float fScaleZ)
         {
+            if (IsDryRun)
+                return true;
+
             OnPlayerEditAttachedObject(BasePlayer.FindOrCreate(playerid),
                 new EditAttachedObjectEventArgs((EditObjectResponse) response, index, modelid, (Bone) boneid,
                     new Vector3(fOffsetX, fOffsetY, fOffsetZ), new Vector3(fRotX, fRotY, fRotZ),
@@ -577,6 +725,9 @@ namespace SampSharp.GameMode
         internal bool OnPlayerSelectObject(int playerid, int type, int objectid, int modelid, float fX, float fY,
             float fZ)
         {
+            if (IsDryRun)
+                return true;
+
             switch ((ObjectType) type)
             {
                 case ObjectType.GlobalObject:
@@ -612,6 +763,9 @@ namespace SampSharp.GameMode
         internal bool OnPlayerWeaponShot(int playerid, int weaponid, int hittype, int hitid, float fX, float fY,
             float fZ)
         {
+            if (IsDryRun)
+                return true;
+
             var args = new WeaponShotEventArgs((WeaponType) weaponid, (BulletHitType) hittype, hitid,
                 new Vector3(fX, fY, fZ));
 
@@ -623,6 +777,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnIncomingConnection(int playerid, string ipAddress, int port)
         {
+            if (IsDryRun)
+                return true;
+
             OnIncomingConnection(new ConnectionEventArgs(playerid, ipAddress, port));
 
             return true;
@@ -631,6 +788,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnVehicleSirenStateChange(int playerid, int vehicleid, bool newstate)
         {
+            if (IsDryRun)
+                return true;
+
             var vehicle = BaseVehicle.Find(vehicleid);
 
             if (vehicle == null)
@@ -644,6 +804,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnActorStreamIn(int actorid, int forplayerid)
         {
+            if (IsDryRun)
+                return true;
+
             var actor = Actor.Find(actorid);
 
             if (actor == null)
@@ -657,6 +820,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnActorStreamOut(int actorid, int forplayerid)
         {
+            if (IsDryRun)
+                return true;
+
             var actor = Actor.Find(actorid);
 
             if (actor == null)
@@ -670,6 +836,9 @@ namespace SampSharp.GameMode
         [Callback]
         internal bool OnPlayerGiveDamageActor(int playerid, int damagedActorid, float amount, int weaponid, int bodypart)
         {
+            if (IsDryRun)
+                return true;
+
             var actor = Actor.Find(damagedActorid);
 
             if (actor == null)
@@ -0,0 +1,125 @@
+﻿// SampSharp
+// Copyright 2018 Tim Potze
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+using System;
+using System.Linq;
+using System.Text;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using SampSharp.Core.Callbacks;
+using SampSharp.Core.Communication;
+
+namespace SampSharp.UnitTests.Core.Callbacks
+{
+    [TestClass]
+    public class CallbackFilterTest
+    {
+        private const byte Prefix = 0x01;
+        private const byte Mask = 0x02;
+        private const byte Range = 0x03;
+        private const byte Reject = 0x04;
+        private const byte NoArgument = 0xff;
+
+        private static byte[] Expected(string name, int defaultReturnValue, params object[] predicates)
+        {
+            return ValueConverter.GetBytes(name, Encoding.ASCII)
+                .Concat(ValueConverter.GetBytes(defaultReturnValue))
+                .Concat(Bytes(predicates))
+                .Concat(new byte[] { 0x00 })
+                .ToArray();
+        }
+
+        // Bytes are written as is, integers and strings as the server reads them.
+        private static byte[] Bytes(object[] values)
+        {
+            return values.SelectMany(v => v is byte b ? new[] { b }
+                : v is int i ? ValueConverter.GetBytes(i)
+                : ValueConverter.GetBytes((string) v, Encoding.ASCII)).ToArray();
+        }
+
+        private static byte[] GetBytes(CallbackFilter filter)
+        {
+            return filter.GetBytes("OnTest", Encoding.ASCII);
+        }
+
+        [TestMethod]
+        public void EmptyFilterTest()
+        {
+            CollectionAssert.AreEqual(Expected("OnTest", 1), GetBytes(new CallbackFilter()));
+        }
+
+        [TestMethod]
+        public void DefaultReturnValueTest()
+        {
+            CollectionAssert.AreEqual(Expected("OnTest", 0, Reject), GetBytes(new CallbackFilter(0).Reject()));
+        }
+
+        [TestMethod]
+        public void PrefixTest()
+        {
+            var filter = new CallbackFilter().Prefix(1, new[] { "/help", "/kill" });
+
+            CollectionAssert.AreEqual(Expected("OnTest", 1, Prefix, (byte) 1, (byte) 0x03, 2, "/help", "/kill"),
+                GetBytes(filter));
+        }
+
+        [TestMethod]
+        public void PrefixFlagsTest()
+        {
+            var filter = new CallbackFilter().Prefix(1, new[] { "/help" }, false, false);
+
+            CollectionAssert.AreEqual(Expected("OnTest", 1, Prefix, (byte) 1, (byte) 0x00, 1, "/help"),
+                GetBytes(filter));
+        }
+
+        [TestMethod]
+        public void MaskTest()
+        {
+            var filter = new CallbackFilter().Mask(1, 0x0c);
+
+            CollectionAssert.AreEqual(Expected("OnTest", 1, Mask, (byte) 1, NoArgument, 0x0c), GetBytes(filter));
+        }
+
+        [TestMethod]
+        public void ChangedMaskTest()
+        {
+            var filter = new CallbackFilter().ChangedMask(1, 2, 0x0c);
+
+            CollectionAssert.AreEqual(Expected("OnTest", 1, Mask, (byte) 1, (byte) 2, 0x0c), GetBytes(filter));
+        }
+
+        [TestMethod]
+        public void RangeTest()
+        {
+            var filter = new CallbackFilter().Range(0, -1, 499);
+
+            CollectionAssert.AreEqual(Expected("OnTest", 1, Range, (byte) 0, -1, 499), GetBytes(filter));
+        }
+
+        [TestMethod]
+        public void CombinedPredicatesTest()
+        {
+            var filter = new CallbackFilter().Range(0, 0, 9).Mask(1, 4);
+
+            CollectionAssert.AreEqual(Expected("OnTest", 1, Range, (byte) 0, 0, 9, Mask, (byte) 1, NoArgument, 4),
+                GetBytes(filter));
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentOutOfRangeException))]
+        public void InvalidArgumentIndexTest()
+        {
+            new CallbackFilter().Mask(0xff, 1);
+        }
+    }
+}
\ No newline at end of file
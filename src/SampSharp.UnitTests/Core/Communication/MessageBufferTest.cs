@@ -0,0 +1,157 @@
+﻿// SampSharp
+// Copyright 2018 Tim Potze
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+using System.Collections.Generic;
+using System.Linq;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using SampSharp.Core.Communication;
+
+namespace SampSharp.UnitTests.Core.Communication
+{
+    [TestClass]
+    public class MessageBufferTest
+    {
+        private static byte[] Frame(ServerCommand command, byte[] data)
+        {
+            return new[] { (byte) command }
+                .Concat(ValueConverter.GetBytes(data.Length))
+                .Concat(data)
+                .ToArray();
+        }
+
+        // Splits a command into chunks the way the server does for frames larger than the maximum frame size.
+        private static IEnumerable<byte[]> Chunks(ServerCommand command, byte[] data, int chunkSize)
+        {
+            for (var position = 0; position < data.Length; position += chunkSize)
+            {
+                var chunk = new[] { (byte) command }
+                    .Concat(ValueConverter.GetBytes(data.Length))
+                    .Concat(data.Skip(position).Take(chunkSize))
+                    .ToArray();
+
+                yield return Frame(ServerCommand.Chunk, chunk);
+            }
+        }
+
+        private static byte[] Data(int length)
+        {
+            return Enumerable.Range(0, length).Select(i => (byte) i).ToArray();
+        }
+
+        private static void Push(MessageBuffer buffer, byte[] bytes)
+        {
+            buffer.Push(bytes, 0, bytes.Length);
+        }
+
+        [TestMethod]
+        public void SingleFrameTest()
+        {
+            var buffer = new MessageBuffer();
+            Push(buffer, Frame(ServerCommand.Response, Data(16)));
+
+            Assert.IsTrue(buffer.TryPop(out var command));
+            Assert.AreEqual(ServerCommand.Response, command.Command);
+            CollectionAssert.AreEqual(Data(16), command.Data);
+            Assert.IsFalse(buffer.TryPop(out command));
+        }
+
+        [TestMethod]
+        public void PartialFrameTest()
+        {
+            var buffer = new MessageBuffer();
+            var frame = Frame(ServerCommand.Response, Data(16));
+
+            buffer.Push(frame, 0, 10);
+            Assert.IsFalse(buffer.TryPop(out var command));
+
+            buffer.Push(frame, 10, frame.Length - 10);
+            Assert.IsTrue(buffer.TryPop(out command));
+            CollectionAssert.AreEqual(Data(16), command.Data);
+        }
+
+        [TestMethod]
+        public void ChunkReassemblyTest()
+        {
+            var buffer = new MessageBuffer();
+            var chunks = Chunks(ServerCommand.Snapshot, Data(1000), 300).ToArray();
+
+            Assert.AreEqual(4, chunks.Length);
+
+            ServerCommandData command;
+            for (var i = 0; i < chunks.Length - 1; i++)
+            {
+                Push(buffer, chunks[i]);
+                Assert.IsFalse(buffer.TryPop(out command));
+            }
+
+            Push(buffer, chunks[chunks.Length - 1]);
+
+            Assert.IsTrue(buffer.TryPop(out command));
+            Assert.AreEqual(ServerCommand.Snapshot, command.Command);
+            CollectionAssert.AreEqual(Data(1000), command.Data);
+        }
+
+        [TestMethod]
+        public void ChunksInSingleReadTest()
+        {
+            var buffer = new MessageBuffer();
+            var bytes = Chunks(ServerCommand.Snapshot, Data(100), 32)
+                .SelectMany(c => c)
+                .Concat(Frame(ServerCommand.Tick, new byte[0]))
+                .ToArray();
+
+            Push(buffer, bytes);
+
+            Assert.IsTrue(buffer.TryPop(out var command));
+            Assert.AreEqual(ServerCommand.Snapshot, command.Command);
+            CollectionAssert.AreEqual(Data(100), command.Data);
+
+            Assert.IsTrue(buffer.TryPop(out command));
+            Assert.AreEqual(ServerCommand.Tick, command.Command);
+        }
+
+        [TestMethod]
+        public void MismatchedChunkTest()
+        {
+            var buffer = new MessageBuffer();
+            var first = Chunks(ServerCommand.Snapshot, Data(100), 60).First();
+            var other = Chunks(ServerCommand.PublicCall, Data(100), 60).Last();
+
+            Push(buffer, first);
+            Push(buffer, other);
+
+            // the mismatched chunk discards the command being reassembled
+            Assert.IsFalse(buffer.TryPop(out var command));
+
+            foreach (var chunk in Chunks(ServerCommand.Snapshot, Data(100), 60))
+                Push(buffer, chunk);
+
+            Assert.IsTrue(buffer.TryPop(out command));
+            CollectionAssert.AreEqual(Data(100), command.Data);
+        }
+
+        [TestMethod]
+        public void ClearDiscardsChunksTest()
+        {
+            var buffer = new MessageBuffer();
+            var chunks = Chunks(ServerCommand.Snapshot, Data(100), 60).ToArray();
+
+            Push(buffer, chunks[0]);
+            buffer.Clear();
+            Push(buffer, chunks[1]);
+
+            Assert.IsFalse(buffer.TryPop(out _));
+        }
+    }
+}
\ No newline at end of file
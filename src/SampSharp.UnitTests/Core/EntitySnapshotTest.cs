@@ -0,0 +1,170 @@
+﻿// SampSharp
+// Copyright 2018 Tim Potze
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+using System;
+using System.Linq;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using SampSharp.Core;
+using SampSharp.Core.Communication;
+
+namespace SampSharp.UnitTests.Core
+{
+    [TestClass]
+    public class EntitySnapshotTest
+    {
+        private static byte[] Keyframe(params int[] cells)
+        {
+            return new byte[] { 1 }
+                .Concat(ValueConverter.GetBytes(cells.Length))
+                .Concat(cells.SelectMany(c => ValueConverter.GetBytes(c)))
+                .ToArray();
+        }
+
+        private static byte[] Delta(int cellCount, int offset, params int[] cells)
+        {
+            return new byte[] { 0 }
+                .Concat(ValueConverter.GetBytes(cellCount))
+                .Concat(ValueConverter.GetBytes(offset))
+                .Concat(ValueConverter.GetBytes(cells.Length))
+                .Concat(cells.SelectMany(c => ValueConverter.GetBytes(c)))
+                .ToArray();
+        }
+
+        private static int[] HealthCells(float first, float second)
+        {
+            // header, connected flags of two players, their health and no vehicles
+            return new[]
+            {
+                (int) EntitySnapshotAttributes.PlayerHealth, 2, 0,
+                1, 1,
+                ValueConverter.ToInt32(first), ValueConverter.ToInt32(second)
+            };
+        }
+
+        [TestMethod]
+        public void KeyframeTest()
+        {
+            var snapshot = new EntitySnapshot();
+
+            snapshot.Apply(Keyframe(HealthCells(100, 50)));
+
+            Assert.AreEqual(EntitySnapshotAttributes.PlayerHealth, snapshot.Attributes);
+            Assert.AreEqual(2, snapshot.PlayerCount);
+            Assert.AreEqual(0, snapshot.VehicleCount);
+            Assert.IsTrue(snapshot.IsPlayerConnected(1));
+            Assert.IsFalse(snapshot.IsPlayerConnected(2));
+            Assert.AreEqual(100f, snapshot.GetPlayerHealth(0));
+            Assert.AreEqual(50f, snapshot.GetPlayerHealth(1));
+        }
+
+        [TestMethod]
+        public void KeyframeLayoutTest()
+        {
+            var snapshot = new EntitySnapshot();
+
+            // header, one player with a position, one vehicle with its health
+            snapshot.Apply(Keyframe(
+                (int) (EntitySnapshotAttributes.PlayerPosition | EntitySnapshotAttributes.VehicleHealth), 1, 1,
+                1,
+                ValueConverter.ToInt32(1f), ValueConverter.ToInt32(2f), ValueConverter.ToInt32(3f),
+                1,
+                ValueConverter.ToInt32(1000f)));
+
+            snapshot.GetPlayerPosition(0, out var x, out var y, out var z);
+
+            Assert.AreEqual(1f, x);
+            Assert.AreEqual(2f, y);
+            Assert.AreEqual(3f, z);
+            Assert.IsTrue(snapshot.VehicleExists(0));
+            Assert.AreEqual(1000f, snapshot.GetVehicleHealth(0));
+        }
+
+        [TestMethod]
+        public void DeltaTest()
+        {
+            var snapshot = new EntitySnapshot();
+
+            snapshot.Apply(Keyframe(HealthCells(100, 50)));
+            snapshot.Apply(Delta(7, 6, ValueConverter.ToInt32(75f)));
+
+            Assert.AreEqual(100f, snapshot.GetPlayerHealth(0));
+            Assert.AreEqual(75f, snapshot.GetPlayerHealth(1));
+        }
+
+        [TestMethod]
+        public void EmptyDeltaTest()
+        {
+            var snapshot = new EntitySnapshot();
+
+            snapshot.Apply(Keyframe(HealthCells(100, 50)));
+            snapshot.Apply(new byte[] { 0 }.Concat(ValueConverter.GetBytes(7)).ToArray());
+
+            Assert.AreEqual(100f, snapshot.GetPlayerHealth(0));
+            Assert.AreEqual(50f, snapshot.GetPlayerHealth(1));
+        }
+
+        [TestMethod]
+        public void KeyframeReplacesSnapshotTest()
+        {
+            var snapshot = new EntitySnapshot();
+
+            snapshot.Apply(Keyframe(HealthCells(100, 50)));
+            snapshot.Apply(Keyframe((int) EntitySnapshotAttributes.PlayerState, 1, 0, 1, 2));
+
+            Assert.AreEqual(EntitySnapshotAttributes.PlayerState, snapshot.Attributes);
+            Assert.AreEqual(1, snapshot.PlayerCount);
+            Assert.AreEqual(2, snapshot.GetPlayerState(0));
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(InvalidOperationException))]
+        public void DeltaSizeMismatchTest()
+        {
+            var snapshot = new EntitySnapshot();
+
+            snapshot.Apply(Keyframe(HealthCells(100, 50)));
+            snapshot.Apply(Delta(8, 6, 0));
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(ArgumentException))]
+        public void InvalidFrameTest()
+        {
+            new EntitySnapshot().Apply(new byte[] { 1, 0 });
+        }
+
+        [TestMethod]
+        [ExpectedException(typeof(InvalidOperationException))]
+        public void MissingAttributeTest()
+        {
+            var snapshot = new EntitySnapshot();
+
+            snapshot.Apply(Keyframe(HealthCells(100, 50)));
+            snapshot.GetPlayerArmour(0);
+        }
+
+        [TestMethod]
+        public void ResetTest()
+        {
+            var snapshot = new EntitySnapshot();
+
+            snapshot.Apply(Keyframe(HealthCells(100, 50)));
+            snapshot.Reset();
+
+            Assert.AreEqual(EntitySnapshotAttributes.None, snapshot.Attributes);
+            Assert.AreEqual(0, snapshot.PlayerCount);
+            Assert.IsFalse(snapshot.IsPlayerConnected(0));
+        }
+    }
+}
\ No newline at end of file
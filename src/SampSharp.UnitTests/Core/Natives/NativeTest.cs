@@ -0,0 +1,142 @@
+﻿// SampSharp
+// Copyright 2018 Tim Potze
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+//     http://www.apache.org/licenses/LICENSE-2.0
+// 
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+using System;
+using System.Text;
+using System.Threading;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+using SampSharp.Core;
+using SampSharp.Core.Natives;
+
+namespace SampSharp.UnitTests.Core.Natives
+{
+    [TestClass]
+    public class NativeTest
+    {
+        private class NoGameModeProvider : IGameModeProvider
+        {
+            public void Initialize(IGameModeClient client)
+            {
+            }
+
+            public void Tick()
+            {
+            }
+
+            public void Dispose()
+            {
+            }
+        }
+
+        private static Native Create(params NativeParameterType[] types)
+        {
+            var client = new HostedGameModeClient(GameModeStartBehaviour.None, new NoGameModeProvider(),
+                Encoding.ASCII);
+            var parameters = Array.ConvertAll(types, type => new NativeParameterInfo(type));
+
+            return new Native(client, "Test", 0, parameters);
+        }
+
+        [TestMethod]
+        public void ValuesOnlyTest()
+        {
+            var native = Create(NativeParameterType.Int32, NativeParameterType.Single, NativeParameterType.Bool);
+
+            Assert.IsTrue(native.IsValuesOnly);
+            Assert.IsFalse(native.IsIntFloat3);
+        }
+
+        [TestMethod]
+        public void IntFloat3Test()
+        {
+            var native = Create(NativeParameterType.Int32, NativeParameterType.Single, NativeParameterType.Single,
+                NativeParameterType.Single);
+
+            Assert.IsTrue(native.IsValuesOnly);
+            Assert.IsTrue(native.IsIntFloat3);
+        }
+
+        [TestMethod]
+        public void NoParametersTest()
+        {
+            var native = Create();
+
+            Assert.IsTrue(native.IsValuesOnly);
+            Assert.IsFalse(native.IsIntFloat3);
+        }
+
+        [TestMethod]
+        public void StringParameterTest()
+        {
+            var native = Create(NativeParameterType.Int32, NativeParameterType.String);
+
+            Assert.IsFalse(native.IsValuesOnly);
+            Assert.IsFalse(native.IsIntFloat3);
+        }
+
+        [TestMethod]
+        public void ReferenceParameterTest()
+        {
+            var native = Create(NativeParameterType.Int32, NativeParameterType.SingleReference,
+                NativeParameterType.SingleReference, NativeParameterType.SingleReference);
+
+            Assert.IsFalse(native.IsValuesOnly);
+            Assert.IsFalse(native.IsIntFloat3);
+        }
+
+        [TestMethod]
+        public void TryGetValuesTest()
+        {
+            var native = Create(NativeParameterType.Int32, NativeParameterType.Single, NativeParameterType.Bool);
+            var values = new int[3];
+
+            Assert.IsTrue(native.TryGetValues(new object[] { 5, 1.5f, true }, values));
+            CollectionAssert.AreEqual(new[] { 5, BitConverter.ToInt32(BitConverter.GetBytes(1.5f), 0), 1 }, values);
+        }
+
+        [TestMethod]
+        public void TryGetValuesMismatchTest()
+        {
+            var native = Create(NativeParameterType.Int32, NativeParameterType.Single);
+
+            // arguments of another type fall back to the serialized call
+            Assert.IsFalse(native.TryGetValues(new object[] { 5, 1.5 }, new int[2]));
+            Assert.IsFalse(native.TryGetValues(new object[] { 5f, 1.5f }, new int[2]));
+        }
+
+        [TestMethod]
+        public void ScratchValuesTest()
+        {
+            var values = Native.GetScratchValues(3);
+
+            Assert.AreEqual(3, values.Length);
+            Assert.AreSame(values, Native.GetScratchValues(3));
+            Assert.AreNotSame(Native.GetScratchValues(100), Native.GetScratchValues(100));
+        }
+
+        [TestMethod]
+        public void ScratchValuesPerThreadTest()
+        {
+            var values = Native.GetScratchValues(3);
+            int[] other = null;
+
+            var thread = new Thread(() => other = Native.GetScratchValues(3));
+            thread.Start();
+            thread.Join();
+
+            Assert.IsNotNull(other);
+            Assert.AreNotSame(values, other);
+        }
+    }
+}
\ No newline at end of file
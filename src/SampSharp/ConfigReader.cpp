@@ -72,6 +72,13 @@ void ConfigReader::GetOptionAsString(const std::string &name, std::string &value
     value = GetOptionAsStringDefault(name, value);
 }
 
+void ConfigReader::GetOptionValues(const std::string &name, std::vector<std::string> &values) const {
+    std::pair<OptionMap::const_iterator, OptionMap::const_iterator> range = options_.equal_range(name);
+    for (OptionMap::const_iterator iterator = range.first; iterator != range.second; ++iterator) {
+        values.push_back(iterator->second);
+    }
+}
+
 std::string ConfigReader::GetOptionAsStringDefault(const std::string &name, const std::string &default_) const {
     OptionMap::const_iterator iterator = options_.find(name);
     return iterator != options_.end() ? iterator->second : default_;
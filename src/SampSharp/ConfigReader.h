@@ -25,12 +25,13 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #pragma once
 
 class ConfigReader {
 public:
-    typedef std::map<std::string, std::string> OptionMap;
+    typedef std::multimap<std::string, std::string> OptionMap;
 
     ConfigReader();
     ConfigReader(const std::string &filename);
@@ -47,6 +48,8 @@ public:
 
     std::string GetOptionAsStringDefault(const std::string &name, const std::string &defaultValue) const;
 
+    void GetOptionValues(const std::string &name, std::vector<std::string> &values) const;
+
     bool IsLoaded() const { return loaded_; }
 
 private:
@@ -0,0 +1,135 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "arena.h"
+#include <assert.h>
+#include <stddef.h>
+#include "logging.h"
+
+arena::arena(uint32_t size) :
+    buf_(new uint8_t[size]),
+    size_(size),
+    initial_size_(size),
+    pos_(0),
+    small_resets_(0),
+    overflow_size_(0),
+    depth_(0),
+    allocations_(0),
+    heap_allocations_(0) {
+}
+
+arena::~arena() {
+    for (size_t i = 0; i < overflow_.size(); i++) {
+        delete[] overflow_[i];
+    }
+
+    delete[] buf_;
+}
+
+uint8_t *arena::alloc(uint32_t size) {
+    uint32_t aligned = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+    allocations_++;
+
+    if (aligned <= size_ - pos_) {
+        uint8_t *result = buf_ + pos_;
+        pos_ += aligned;
+        return result;
+    }
+
+    /* the arena is full; serve the allocation from the heap and grow the
+     * arena at the next reset so this won't happen again */
+    heap_allocations_++;
+    overflow_size_ += aligned;
+
+    uint8_t *result = new uint8_t[aligned];
+    overflow_.push_back(result);
+    return result;
+}
+
+void arena::enter() {
+    depth_++;
+}
+
+void arena::leave() {
+    assert(depth_ > 0);
+
+    if (--depth_ == 0) {
+        reset();
+    }
+}
+
+void arena::reset() {
+    if (depth_ > 0) {
+        return;
+    }
+
+    uint32_t used = pos_;
+    pos_ = 0;
+
+    /* shrink after a spike once a while has passed without one */
+    if (overflow_.empty() && size_ > initial_size_) {
+        small_resets_ = used <= initial_size_ ? small_resets_ + 1 : 0;
+
+        if (small_resets_ >= ARENA_TRIM_RESETS) {
+            small_resets_ = 0;
+            size_ = initial_size_;
+
+            delete[] buf_;
+            buf_ = new uint8_t[size_];
+
+            log_debug("Arena shrunk to %d bytes.", size_);
+        }
+        return;
+    }
+
+    if (!overflow_.empty()) {
+        small_resets_ = 0;
+
+        for (size_t i = 0; i < overflow_.size(); i++) {
+            delete[] overflow_[i];
+        }
+        overflow_.clear();
+
+        /* spikes beyond the maximum size keep using the heap */
+        uint32_t size = size_ + overflow_size_;
+        overflow_size_ = 0;
+
+        if (size > ARENA_MAX_SIZE) {
+            return;
+        }
+
+        size_ = size;
+
+        delete[] buf_;
+        buf_ = new uint8_t[size_];
+
+        log_debug("Arena grown to %d bytes after %d heap allocations.", size_,
+            (int)heap_allocations_);
+    }
+}
+
+void arena::log_stats() {
+    if (allocations_ == 0) {
+        return;
+    }
+
+    log_info("Arena: %llu allocations, %llu from the heap, %u bytes.",
+        (unsigned long long)allocations_,
+        (unsigned long long)heap_allocations_, size_);
+
+    allocations_ = heap_allocations_ = 0;
+}
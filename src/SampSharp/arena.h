@@ -0,0 +1,79 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <inttypes.h>
+#include <vector>
+
+#define ARENA_ALIGN             (8)
+#define ARENA_MAX_SIZE          (1024 * 1024)
+#define ARENA_TRIM_RESETS       (200) /* resets below the initial size before shrinking */
+
+/** a bump-pointer allocator for short-lived buffers. allocations are freed
+ * all at once by reset, which has no effect while a scope is still entered so
+ * nested calls don't release memory their callers are still using. the arena
+ * grows after spikes and shrinks back once they have passed. */
+class arena
+{
+public:
+    arena(uint32_t size);
+    ~arena();
+    /** allocates a buffer which lives until the next reset */
+    uint8_t *alloc(uint32_t size);
+    /** enters a scope */
+    void enter();
+    /** leaves a scope; resets the arena when leaving the outermost scope */
+    void leave();
+    /** frees all allocations if no scope is entered */
+    void reset();
+    /** number of allocations made since the stats were last logged */
+    uint64_t allocations() const { return allocations_; }
+    /** number of allocations which could not be served by the arena since
+     * the stats were last logged; stays zero in steady state */
+    uint64_t heap_allocations() const { return heap_allocations_; }
+    /** logs and clears the allocation counters */
+    void log_stats();
+    /** the capacity of the arena */
+    uint32_t capacity() const { return size_; }
+private:
+    arena(const arena &);
+    arena &operator=(const arena &);
+    uint8_t *buf_;
+    uint32_t size_;
+    uint32_t initial_size_;
+    uint32_t pos_;
+    /** number of consecutive resets which used no more than the initial
+     * size */
+    uint32_t small_resets_;
+    uint32_t overflow_size_;
+    int depth_;
+    std::vector<uint8_t *> overflow_;
+    uint64_t allocations_;
+    uint64_t heap_allocations_;
+};
+
+/** enters an arena scope for the lifetime of this object */
+class arena_scope
+{
+public:
+    arena_scope(arena *a) : arena_(a) { arena_->enter(); }
+    ~arena_scope() { arena_->leave(); }
+private:
+    arena_scope(const arena_scope &);
+    arena_scope &operator=(const arena_scope &);
+    arena *arena_;
+};
@@ -0,0 +1,132 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "buffer_pool.h"
+#include <assert.h>
+#include <stddef.h>
+
+buffer_pool::buffer_pool() :
+    idle_ticks_(0) {
+}
+
+buffer_pool::~buffer_pool() {
+    clear();
+}
+
+int buffer_pool::size_class(uint32_t size) {
+    int cls = 0;
+    uint32_t cls_size = POOL_MIN_SIZE;
+
+    while (cls_size < size) {
+        if (++cls == POOL_CLASSES) {
+            return -1;
+        }
+        cls_size <<= 1;
+    }
+
+    return cls;
+}
+
+uint8_t *buffer_pool::acquire(uint32_t size, uint32_t *capacity) {
+    assert(capacity);
+
+    int cls = size_class(size);
+
+    if (cls < 0) {
+        *capacity = 0;
+        return NULL;
+    }
+
+    if (cls >= POOL_KEEP_CLASSES) {
+        idle_ticks_ = 0;
+    }
+
+    *capacity = POOL_MIN_SIZE << cls;
+
+    if (!free_[cls].empty()) {
+        uint8_t *buf = free_[cls].back();
+        free_[cls].pop_back();
+        return buf;
+    }
+
+    return new uint8_t[*capacity];
+}
+
+void buffer_pool::release(uint8_t *buf, uint32_t capacity) {
+    if (!buf) {
+        return;
+    }
+
+    int cls = size_class(capacity);
+    assert(cls >= 0 && (uint32_t)(POOL_MIN_SIZE << cls) == capacity);
+
+    if (free_[cls].size() >= POOL_KEEP_COUNT) {
+        delete[] buf;
+        return;
+    }
+
+    free_[cls].push_back(buf);
+}
+
+void buffer_pool::trim() {
+    if (++idle_ticks_ < POOL_TRIM_TICKS) {
+        return;
+    }
+
+    idle_ticks_ = 0;
+
+    for (int cls = POOL_KEEP_CLASSES; cls < POOL_CLASSES; cls++) {
+        for (size_t i = 0; i < free_[cls].size(); i++) {
+            delete[] free_[cls][i];
+        }
+        free_[cls].clear();
+    }
+}
+
+void buffer_pool::clear() {
+    for (int cls = 0; cls < POOL_CLASSES; cls++) {
+        for (size_t i = 0; i < free_[cls].size(); i++) {
+            delete[] free_[cls][i];
+        }
+        free_[cls].clear();
+    }
+}
+
+pooled_buffer::pooled_buffer(buffer_pool *pool) :
+    pool_(pool),
+    buf_(NULL),
+    capacity_(0) {
+}
+
+pooled_buffer::pooled_buffer(buffer_pool *pool, uint32_t size) :
+    pool_(pool),
+    buf_(NULL),
+    capacity_(0) {
+    acquire(size);
+}
+
+pooled_buffer::~pooled_buffer() {
+    pool_->release(buf_, capacity_);
+}
+
+uint8_t *pooled_buffer::acquire(uint32_t size) {
+    if (buf_ && capacity_ >= size) {
+        return buf_;
+    }
+
+    pool_->release(buf_, capacity_);
+    return buf_ = pool_->acquire(size, &capacity_);
+}
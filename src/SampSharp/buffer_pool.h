@@ -0,0 +1,66 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <inttypes.h>
+#include <vector>
+
+#define POOL_MIN_SIZE           (1024 * 4)
+#define POOL_CLASSES            (13) /* 4 KB up to 16 MB */
+#define POOL_MAX_SIZE           (POOL_MIN_SIZE << (POOL_CLASSES - 1))
+#define POOL_KEEP_CLASSES       (4) /* classes up to 32 KB are never trimmed */
+#define POOL_KEEP_COUNT         (4) /* free buffers kept per class */
+#define POOL_TRIM_TICKS         (200) /* idle ticks before large buffers are freed */
+
+/** a pool of buffers in power-of-two size classes */
+class buffer_pool
+{
+public:
+    buffer_pool();
+    ~buffer_pool();
+    /** acquires a buffer of at least the specified size; NULL if too large */
+    uint8_t *acquire(uint32_t size, uint32_t *capacity);
+    /** returns a buffer acquired from this pool */
+    void release(uint8_t *buf, uint32_t capacity);
+    /** frees large buffers which have not been used for a while */
+    void trim();
+    /** frees all free buffers */
+    void clear();
+private:
+    static int size_class(uint32_t size);
+    std::vector<uint8_t *> free_[POOL_CLASSES];
+    uint32_t idle_ticks_;
+};
+
+/** a buffer which is returned to its pool when it goes out of scope */
+class pooled_buffer
+{
+public:
+    pooled_buffer(buffer_pool *pool);
+    pooled_buffer(buffer_pool *pool, uint32_t size);
+    ~pooled_buffer();
+    /** acquires a buffer of at least the specified size */
+    uint8_t *acquire(uint32_t size);
+    uint8_t *get() const { return buf_; }
+    uint32_t capacity() const { return capacity_; }
+private:
+    pooled_buffer(const pooled_buffer &);
+    pooled_buffer &operator=(const pooled_buffer &);
+    buffer_pool *pool_;
+    uint8_t *buf_;
+    uint32_t capacity_;
+};
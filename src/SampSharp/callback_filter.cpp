@@ -0,0 +1,206 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "callback_filter.h"
+#include <ctype.h>
+#include <string.h>
+#include "logging.h"
+
+callback_filter::callback_filter() :
+    retval_(0),
+    rejected_(0) {
+}
+
+bool callback_filter::parse(const uint8_t *buf, uint32_t len) {
+    const uint8_t *ptr = buf, *end = buf + len;
+    predicates_.clear();
+
+#define FILTER_READ(type, var) \
+    if (end - ptr < (int)sizeof(type)) return false; \
+    var = *(type *)ptr; \
+    ptr += sizeof(type)
+
+    FILTER_READ(int32_t, retval_);
+
+    for (;;) {
+        predicate p = predicate();
+        uint32_t count;
+
+        FILTER_READ(uint8_t, p.type);
+
+        switch (p.type) {
+            case FILTER_END:
+                return true;
+            case FILTER_PREFIX:
+                FILTER_READ(uint8_t, p.arg);
+                FILTER_READ(uint8_t, p.flags);
+                FILTER_READ(uint32_t, count);
+
+                p.trie.push_back(trie_node());
+                p.trie[0].terminal = false;
+
+                for (uint32_t i = 0; i < count; i++) {
+                    const uint8_t *str = ptr;
+                    while (ptr < end && *ptr) {
+                        ptr++;
+                    }
+                    if (ptr == end) {
+                        return false;
+                    }
+                    ptr++;
+
+                    trie_insert(p.trie, (const char *)str,
+                        (p.flags & FILTER_IGNORE_CASE) != 0);
+                }
+                break;
+            case FILTER_MASK:
+                FILTER_READ(uint8_t, p.arg);
+                FILTER_READ(uint8_t, p.other);
+                FILTER_READ(uint32_t, p.mask);
+                break;
+            case FILTER_RANGE:
+                FILTER_READ(uint8_t, p.arg);
+                FILTER_READ(int32_t, p.min);
+                FILTER_READ(int32_t, p.max);
+                break;
+            case FILTER_REJECT:
+                break;
+            default:
+                log_error("Invalid callback filter predicate %d.", p.type);
+                return false;
+        }
+
+        predicates_.push_back(p);
+    }
+#undef FILTER_READ
+}
+
+void callback_filter::trie_insert(std::vector<trie_node> &trie,
+    const char *str, const bool ignore_case) {
+    uint32_t node = 0;
+
+    for (; *str; str++) {
+        uint8_t c = ignore_case
+            ? (uint8_t)tolower((unsigned char)*str) : (uint8_t)*str;
+        uint32_t next = 0;
+
+        for (size_t i = 0; i < trie[node].children.size(); i++) {
+            if (trie[node].children[i].first == c) {
+                next = trie[node].children[i].second;
+                break;
+            }
+        }
+
+        if (!next) {
+            next = (uint32_t)trie.size();
+            trie[node].children.push_back(std::make_pair(c, next));
+            trie.push_back(trie_node());
+            trie[next].terminal = false;
+        }
+
+        node = next;
+    }
+
+    trie[node].terminal = true;
+}
+
+bool callback_filter::trie_match(const std::vector<trie_node> &trie,
+    const char *str, const uint8_t flags) {
+    uint32_t node = 0;
+
+    for (;; str++) {
+        if (trie[node].terminal && (!(flags & FILTER_WORD) ||
+            *str == '\0' || *str == ' ')) {
+            return true;
+        }
+
+        if (!*str) {
+            return false;
+        }
+
+        uint8_t c = (flags & FILTER_IGNORE_CASE)
+            ? (uint8_t)tolower((unsigned char)*str) : (uint8_t)*str;
+        uint32_t next = 0;
+
+        for (size_t i = 0; i < trie[node].children.size(); i++) {
+            if (trie[node].children[i].first == c) {
+                next = trie[node].children[i].second;
+                break;
+            }
+        }
+
+        if (!next) {
+            return false;
+        }
+
+        node = next;
+    }
+}
+
+bool callback_filter::evaluate(const predicate &p, AMX *amx,
+    cell *params) const {
+    uint32_t params_count = params[0] / sizeof(cell);
+    char str[LEN_FILTER_STRING];
+    cell *addr = NULL;
+    cell value;
+
+    if (p.type == FILTER_REJECT) {
+        return false;
+    }
+
+    /* calls not matching the filter layout are forwarded */
+    if (p.arg >= params_count ||
+        (p.other != FILTER_NO_ARG && p.other >= params_count)) {
+        return true;
+    }
+
+    value = params[p.arg + 1];
+
+    switch (p.type) {
+        case FILTER_PREFIX:
+            amx_GetAddr(amx, value, &addr);
+            if (!addr) {
+                return trie_match(p.trie, "", p.flags);
+            }
+
+            amx_GetString(str, addr, 0, sizeof(str));
+            return trie_match(p.trie, str, p.flags);
+        case FILTER_MASK:
+            if (p.other != FILTER_NO_ARG) {
+                value ^= params[p.other + 1];
+            }
+            return (value & p.mask) != 0;
+        case FILTER_RANGE:
+            return value >= p.min && value <= p.max;
+    }
+
+    return true;
+}
+
+bool callback_filter::accepts(AMX *amx, cell *params, cell *retval) {
+    for (size_t i = 0; i < predicates_.size(); i++) {
+        if (!evaluate(predicates_[i], amx, params)) {
+            rejected_++;
+
+            if (retval) {
+                *retval = retval_;
+            }
+            return false;
+        }
+    }
+
+    return true;
+}
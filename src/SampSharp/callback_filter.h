@@ -0,0 +1,75 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <inttypes.h>
+#include <string>
+#include <vector>
+#include <sampgdk/sampgdk.h>
+
+/* filter buffer: [name\0][i32 default return value] followed by predicates
+ * and FILTER_END. a call is forwarded only if all predicates pass.
+ */
+#define FILTER_END          0x00
+#define FILTER_PREFIX       0x01 /* [u8 arg][u8 flags][u32 count][strings\0] */
+#define FILTER_MASK         0x02 /* [u8 arg][u8 other arg][u32 mask] */
+#define FILTER_RANGE        0x03 /* [u8 arg][i32 min][i32 max] */
+#define FILTER_REJECT       0x04 /* rejects all calls */
+
+#define FILTER_NO_ARG       0xff /* no other argument for FILTER_MASK */
+#define FILTER_WORD         (1 << 0) /* prefix must be followed by a space */
+#define FILTER_IGNORE_CASE  (1 << 1) /* compare prefixes case insensitive */
+
+#define LEN_FILTER_STRING   (256)
+
+/** a set of predicates a call to a callback must pass to be forwarded */
+class callback_filter
+{
+public:
+    callback_filter();
+    /** parses the predicates from a filter buffer; returns false on error */
+    bool parse(const uint8_t *buf, uint32_t len);
+    /** evaluates the predicates for a call; if a predicate fails, retval is
+     * set to the default return value and false is returned */
+    bool accepts(AMX *amx, cell *params, cell *retval);
+    bool empty() const { return predicates_.empty(); }
+    uint32_t rejected() const { return rejected_; }
+private:
+    /** a node of a prefix trie */
+    struct trie_node {
+        std::vector<std::pair<uint8_t, uint32_t> > children;
+        bool terminal;
+    };
+    struct predicate {
+        uint8_t type;
+        uint8_t arg;
+        uint8_t other;
+        uint8_t flags;
+        uint32_t mask;
+        int32_t min;
+        int32_t max;
+        std::vector<trie_node> trie;
+    };
+    static void trie_insert(std::vector<trie_node> &trie, const char *str,
+        bool ignore_case);
+    static bool trie_match(const std::vector<trie_node> &trie,
+        const char *str, uint8_t flags);
+    bool evaluate(const predicate &p, AMX *amx, cell *params) const;
+    std::vector<predicate> predicates_;
+    cell retval_;
+    uint32_t rejected_;
+};
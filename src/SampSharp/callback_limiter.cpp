@@ -0,0 +1,203 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "callback_limiter.h"
+#include <chrono>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include "logging.h"
+
+/** the current time in milliseconds */
+static uint64_t time_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+callback_limiter::callback_limiter() :
+    last_(NULL),
+    last_key_(0) {
+}
+
+callback_limiter::~callback_limiter() {
+    log_stats();
+}
+
+void callback_limiter::load_config(const std::string &value) {
+    /* format: name=<interval in ms>[:<return value>] separated by spaces */
+    std::istringstream stream(value);
+    std::string pair;
+
+    while (stream >> pair) {
+        size_t sep = pair.find('=');
+        int interval = sep == std::string::npos
+            ? 0 : atoi(pair.c_str() + sep + 1);
+
+        if (interval <= 0) {
+            log_warning("Invalid callback rate configuration '%s'.",
+                pair.c_str());
+            continue;
+        }
+
+        size_t ret = pair.find(':', sep);
+
+        rate_limit &limit = limits_[pair.substr(0, sep)];
+        limit.interval = (uint32_t)interval;
+        limit.retval = ret == std::string::npos
+            ? LIMIT_DEFAULT_RETVAL : atoi(pair.c_str() + ret + 1);
+        limit.slots.resize(LIMIT_MAX_KEYS);
+        limit.forwarded = limit.coalesced = limit.dropped = 0;
+    }
+}
+
+bool callback_limiter::limit(const char *name, cell *params) {
+    last_ = NULL;
+
+    if (limits_.empty() || params[0] < (cell)sizeof(cell) ||
+        params[1] < 0 || params[1] >= LIMIT_MAX_KEYS) {
+        return false;
+    }
+
+    limits_map::iterator it = limits_.find(name);
+    if (it == limits_.end()) {
+        return false;
+    }
+
+    rate_limit &limit = it->second;
+    slot &s = limit.slots[params[1]];
+    uint64_t now = time_ms();
+
+    if (now >= s.window_end && !s.pending) {
+        /* forward the call and open a new window */
+        s.window_end = now + limit.interval;
+        limit.forwarded++;
+        return false;
+    }
+
+    /* the slot is only taken once the call has been serialized */
+    last_ = &s;
+    last_limit_ = it;
+    last_key_ = (uint32_t)params[1];
+    return true;
+}
+
+void callback_limiter::defer(const uint8_t *buf, uint32_t len, cell *retval) {
+    if (!last_) {
+        return;
+    }
+
+    rate_limit &limit = last_limit_->second;
+
+    if (last_->pending) {
+        /* superseded by this call */
+        limit.dropped++;
+    }
+    else {
+        last_->pending = true;
+        pending_.push_back(std::make_pair(last_limit_, last_key_));
+    }
+
+    last_->buf.assign(buf, buf + len);
+    last_ = NULL;
+
+    if (retval) {
+        *retval = limit.retval;
+    }
+}
+
+void callback_limiter::release(const char *name, cell *params) {
+    if (limits_.empty() || params[0] < (cell)sizeof(cell) ||
+        params[1] < 0 || params[1] >= LIMIT_MAX_KEYS ||
+        (strcmp(name, "OnPlayerConnect") &&
+        strcmp(name, "OnPlayerDisconnect"))) {
+        return;
+    }
+
+    uint32_t key = (uint32_t)params[1];
+
+    for (limits_map::iterator it = limits_.begin(); it != limits_.end(); it++) {
+        slot &s = it->second.slots[key];
+        s.window_end = 0;
+        s.pending = false;
+        s.buf.clear();
+    }
+
+    for (size_t i = pending_.size(); i > 0; i--) {
+        if (pending_[i - 1].second == key) {
+            pending_.erase(pending_.begin() + (i - 1));
+        }
+    }
+
+    last_ = NULL;
+}
+
+bool callback_limiter::next_due(due_call *call) {
+    uint64_t now = time_ms();
+
+    for (size_t i = 0; i < pending_.size(); i++) {
+        rate_limit &limit = pending_[i].first->second;
+        slot &s = limit.slots[pending_[i].second];
+
+        if (s.window_end > now) {
+            continue;
+        }
+
+        /* deliver the latest call and open a new window; the slot keeps its
+         * buffer so later deferrals don't allocate */
+        call->name = pending_[i].first->first.c_str();
+        call->buf = s.buf.empty() ? NULL : &s.buf[0];
+        call->len = (uint32_t)s.buf.size();
+        s.pending = false;
+        s.window_end = now + limit.interval;
+        limit.coalesced++;
+
+        pending_.erase(pending_.begin() + i);
+        return true;
+    }
+
+    return false;
+}
+
+void callback_limiter::reset() {
+    for (limits_map::iterator it = limits_.begin(); it != limits_.end(); it++) {
+        std::vector<slot> &slots = it->second.slots;
+        for (size_t i = 0; i < slots.size(); i++) {
+            slots[i].window_end = 0;
+            slots[i].pending = false;
+            slots[i].buf.clear();
+        }
+    }
+
+    log_stats();
+    pending_.clear();
+    last_ = NULL;
+}
+
+void callback_limiter::log_stats() {
+    for (limits_map::iterator it = limits_.begin(); it != limits_.end(); it++) {
+        rate_limit &limit = it->second;
+
+        if (limit.forwarded + limit.coalesced + limit.dropped == 0) {
+            continue;
+        }
+
+        log_info("Callback rate limit %s: %u forwarded, %u coalesced, "
+            "%u dropped.", it->first.c_str(), limit.forwarded,
+            limit.coalesced, limit.dropped);
+
+        limit.forwarded = limit.coalesced = limit.dropped = 0;
+    }
+}
@@ -0,0 +1,82 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <inttypes.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <sampgdk/sampgdk.h>
+
+#define LIMIT_MAX_KEYS          (1000) /* keys are player ids */
+#define LIMIT_DEFAULT_RETVAL    (1)
+
+/** limits the rate at which callbacks are forwarded per value of their first
+ * argument. the first call in a window is forwarded; later calls in the same
+ * window are deferred and only the latest one is delivered at window end */
+class callback_limiter
+{
+public:
+    /** a deferred call whose window has ended; the buffer is owned by the
+     * limiter and valid until the next call to the limiter */
+    struct due_call {
+        const char *name;
+        const uint8_t *buf;
+        uint32_t len;
+    };
+
+    callback_limiter();
+    ~callback_limiter();
+    /** loads rate limits from a list of name=interval[:retval] pairs */
+    void load_config(const std::string &value);
+    /** checks whether a call can be forwarded now; otherwise true is returned
+     * and the caller must store the call using defer */
+    bool limit(const char *name, cell *params);
+    /** stores the serialized call which was limited last and sets retval to
+     * the configured value */
+    void defer(const uint8_t *buf, uint32_t len, cell *retval);
+    /** discards the windows and deferred calls of a player when the player
+     * connects or disconnects */
+    void release(const char *name, cell *params);
+    /** takes the next deferred call whose window has ended */
+    bool next_due(due_call *call);
+    /** discards all deferred calls */
+    void reset();
+private:
+    struct slot {
+        uint64_t window_end;
+        bool pending;
+        std::vector<uint8_t> buf;
+    };
+    struct rate_limit {
+        uint32_t interval;
+        cell retval;
+        std::vector<slot> slots;
+        uint32_t forwarded;
+        uint32_t coalesced;
+        uint32_t dropped;
+    };
+    typedef std::map<std::string, rate_limit> limits_map;
+    void log_stats();
+    limits_map limits_;
+    /** calls with a pending deferred invocation in order of deferral */
+    std::vector<std::pair<limits_map::iterator, uint32_t> > pending_;
+    /** the slot of the call which was limited last */
+    slot *last_;
+    limits_map::iterator last_limit_;
+    uint32_t last_key_;
+};
@@ -18,6 +18,7 @@
 #include <string.h>
 #include "remote_server.h"
 #include "logging.h"
+#include "simd.h"
 
 #define ARG_TERM    0x00
 #define ARG_VALUE   0x01
@@ -29,164 +30,356 @@ callbacks_map::callbacks_map() {
 }
 
 void callbacks_map::clear() {
-    for (std::map<std::string,uint8_t *>::iterator it = callbacks_.begin(); 
-        it != callbacks_.end(); it++) {
-        delete[] it->second;
-    }
-
     callbacks_.clear();
+    next_id_ = 0;
+
+    clear_filters();
+
+    callback_plan empty;
+    empty.id = -1;
+    empty.params = 0;
+    empty.fixed_len = 0;
+
+    callbacks_["OnGameModeInit"] = empty;
+    callbacks_["OnGameModeExit"] = empty;
+}
 
-    uint8_t
-        *a = new uint8_t[1],
-        *b = new uint8_t[1];
-    a[0] = ARG_TERM;
-    b[0] = ARG_TERM;
+void callbacks_map::clear_filters() {
+    for (std::map<std::string, callback_filter>::const_iterator it =
+        filters_.begin(); it != filters_.end(); it++) {
+        if (it->second.rejected()) {
+            log_info("Callback filter %s: %u calls rejected.",
+                it->first.c_str(), it->second.rejected());
+        }
+    }
 
-    callbacks_["OnGameModeInit"] = a;
-    callbacks_["OnGameModeExit"] = b;
+    filters_.clear();
 }
 
-void callbacks_map::register_buffer(uint8_t *buf) {
+int32_t callbacks_map::register_buffer(uint8_t *buf) {
     assert(buf);
 
     char *name = (char *)buf;
-    size_t 
-        name_len = strlen(name),
-        info_len = 0;
-    uint8_t *info = buf + name_len + 1;
-
-    /* verify buffer and measure length */
-    while (info[info_len] != ARG_TERM) {
-        switch (info[info_len]) {
+    uint8_t *info = buf + strlen(name) + 1;
+    std::vector<uint8_t> types;
+    callback_plan plan;
+    uint32_t index;
+
+    plan.id = -1;
+    plan.params = 0;
+    plan.fixed_len = 0;
+
+    /* verify the buffer and compile it into copy steps; runs of consecutive
+     * values are merged into a single step */
+    while (*info != ARG_TERM) {
+        if (types.size() == UINT16_MAX) {
+            log_error("Too many callback arguments for %s.", name);
+            return -1;
+        }
+
+        callback_op op;
+        op.type = *info++;
+        op.param = (uint16_t)types.size();
+        op.arg = 0;
+        op.reserve = 0;
+        types.push_back(op.type);
+
+        switch (op.type) {
         case ARG_VALUE:
+            plan.fixed_len += sizeof(cell);
+            if (!plan.ops.empty() && plan.ops.back().type == ARG_VALUE) {
+                plan.ops.back().arg++;
+                continue;
+            }
+            op.arg = 1;
+            break;
         case ARG_STRING:
-            info_len++;
+            plan.fixed_len += 1; /* terminator */
             break;
         case ARG_ARRAY:
-            info_len += 5;
+            memcpy(&index, info, sizeof(uint32_t));
+            info += sizeof(uint32_t);
+            op.arg = (uint16_t)index;
+            if (index > UINT16_MAX) {
+                log_error("Invalid callback array size indicator %d.", index);
+                return -1;
+            }
+            plan.fixed_len += sizeof(int); /* length */
             break;
         default:
-            log_error("Invalid callback argument %d.", info[info_len]);
-            return;
+            log_error("Invalid callback argument %d.", op.type);
+            return -1;
+        }
+
+        plan.ops.push_back(op);
+    }
+
+    plan.params = (uint32_t)types.size();
+
+    /* array lengths must refer to value arguments; compute the fixed size
+     * which must remain available after every step */
+    uint32_t reserve = 0;
+    for (std::vector<callback_op>::reverse_iterator it = plan.ops.rbegin();
+        it != plan.ops.rend(); it++) {
+        it->reserve = reserve;
+
+        switch (it->type) {
+        case ARG_VALUE:
+            reserve += it->arg * sizeof(cell);
+            break;
+        case ARG_STRING:
+            reserve += 1;
+            break;
+        case ARG_ARRAY:
+            if (it->arg >= types.size() || types[it->arg] != ARG_VALUE) {
+                log_error("Invalid callback array size indicator %d.",
+                    it->arg);
+                return -1;
+            }
+            reserve += sizeof(int);
+            break;
+        }
+    }
+
+    /* a callback keeps its identifier when registered again */
+    std::map<std::string, callback_plan>::const_iterator it =
+        callbacks_.find(name);
+    plan.id = it != callbacks_.end() && it->second.id >= 0
+        ? it->second.id
+        : next_id_++;
+
+    callbacks_[name] = plan;
+    return plan.id;
+}
+
+int32_t callbacks_map::id(const char *name) const {
+    std::map<std::string, callback_plan>::const_iterator it =
+        callbacks_.find(name);
+    return it == callbacks_.end() ? -1 : it->second.id;
+}
+
+uint32_t callbacks_map::param_count(const char *name) const {
+    std::map<std::string, callback_plan>::const_iterator it =
+        callbacks_.find(name);
+    return it == callbacks_.end() ? 0 : it->second.params;
+}
+
+void callbacks_map::register_filter(const uint8_t *buf, uint32_t len) {
+    assert(buf);
+
+    const char *name = (const char *)buf;
+    size_t name_len = strnlen(name, len);
+
+    if (name_len == len) {
+        log_error("Invalid callback filter.");
+        return;
+    }
+
+    callback_filter filter;
+    if (!filter.parse(buf + name_len + 1, len - (uint32_t)name_len - 1)) {
+        log_error("Invalid callback filter for %s.", name);
+        return;
+    }
+
+    if (filter.empty()) {
+        filters_.erase(name);
+    }
+    else {
+        filters_[name] = filter;
+    }
+}
+
+bool callbacks_map::accepts(AMX *amx, const char *name, cell *params,
+    cell *retval) {
+    if (filters_.empty()) {
+        return true;
+    }
+
+    std::map<std::string, callback_filter>::iterator it = filters_.find(name);
+    return it == filters_.end() || it->second.accepts(amx, params, retval);
+}
+
+uint32_t callbacks_map::measure_call_buffer(AMX *amx,
+    const callback_plan &plan, cell *params, uint32_t name_len) {
+    uint32_t call_len = name_len + plan.fixed_len;
+    int val_len;
+    cell *val_addr;
+
+    for (std::vector<callback_op>::const_iterator op = plan.ops.begin();
+        op != plan.ops.end(); op++) {
+        switch (op->type) {
+            case ARG_STRING:
+                val_len = 0;
+                val_addr = NULL;
+                amx_GetAddr(amx, params[op->param + 1], &val_addr);
+                if (val_addr != NULL) {
+                    if (simd_is_packed(val_addr)) {
+                        amx_StrLen(val_addr, &val_len);
+                    }
+                    else {
+                        val_len = (int)simd_cells_strlen(val_addr);
+                    }
+                }
+                call_len += val_len;
+                break;
+            case ARG_ARRAY:
+                val_len = params[op->arg + 1];
+                if (val_len > 0) {
+                    call_len += val_len * sizeof(cell);
+                }
+                break;
         }
     }
 
-    info_len++;
+    return call_len;
+}
 
-    /* remove previous entry */
-    std::map<std::string, uint8_t *>::const_iterator it = callbacks_.find(name);
-    if (it != callbacks_.end()) {
-        delete[] it->second;
+bool callbacks_map::fill_dry_run_buffer(const char *name, uint8_t *buf,
+    uint32_t *len, bool include_name) const {
+    std::map<std::string, callback_plan>::const_iterator it =
+        callbacks_.find(name);
+    if (it == callbacks_.end()) {
+        return false;
     }
 
-    /* insert new entry */
-    uint8_t *info_buf = new uint8_t[info_len];
-    memcpy(info_buf, info, info_len);
+    /* the fixed size part of a call holds the values, the terminators of
+     * strings and the lengths of arrays; all zero is a call with empty
+     * strings and arrays */
+    uint32_t name_len = include_name ? (uint32_t)strlen(name) + 1 : 0;
+    uint32_t call_len = name_len + it->second.fixed_len;
+
+    if (*len < call_len) {
+        *len = call_len;
+        return false;
+    }
+
+    memcpy(buf, name, name_len);
+    memset(buf + name_len, 0, it->second.fixed_len);
+
+    *len = call_len;
+    return true;
+}
 
-    callbacks_[name] = info_buf;
+void callbacks_map::registered(std::vector<std::string> &names) const {
+    for (std::map<std::string, callback_plan>::const_iterator it =
+        callbacks_.begin(); it != callbacks_.end(); it++) {
+        if (it->second.id >= 0) {
+            names.push_back(it->first);
+        }
+    }
 }
 
 bool callbacks_map::fill_call_buffer(AMX *amx, const char *name, 
     cell *params, uint8_t *buf, uint32_t *len, bool include_name) {
     assert(sizeof(cell) == sizeof(uint32_t));
 
-    uint32_t call_len = 0;
-
     /* find the callback in the map */
-    std::map<std::string, uint8_t *>::const_iterator it = callbacks_.find(name);
+    std::map<std::string, callback_plan>::const_iterator it =
+        callbacks_.find(name);
     if (it == callbacks_.end()) {
         return false;
     }
 
-    if(include_name) {
-        /* fill the buffer with the callback name */
-        size_t name_len = strlen(name);
-        if (*len < name_len + 1) {
-            log_error("Callback buffer too small.");
+    const callback_plan &plan = it->second;
+    uint32_t params_count = params[0] / sizeof(cell);
+    uint32_t name_len = include_name ? (uint32_t)strlen(name) + 1 : 0;
+    uint32_t call_len = name_len;
+
+    if (params_count != plan.params) {
+        log_error("Callback parameters count mismatch. Expecting %d but "
+            "received %d parameters.", plan.params, params_count);
+
+        if (params_count < plan.params) {
             return false;
         }
+    }
 
-        memcpy(buf, name, name_len + 1);
-        call_len = name_len + 1;
+    /* the fixed size part of the call is checked once; the steps below only
+     * check the variable size of strings and arrays */
+    if (*len < name_len + plan.fixed_len) {
+        *len = measure_call_buffer(amx, plan, params, name_len);
+        return false;
     }
 
+    /* fill the buffer with the callback name */
+    memcpy(buf, name, name_len);
+
     /* fill the buffer with the callback arguments */
-    uint32_t i = 0;
-    uint32_t params_count = params[0] / sizeof(cell);
-    for (uint8_t *info = it->second; *info != ARG_TERM; i++) {
+    for (std::vector<callback_op>::const_iterator op = plan.ops.begin();
+        op != plan.ops.end(); op++) {
+        uint32_t available = *len - call_len - op->reserve;
+        uint32_t size;
         int val_len = 0;
         cell *val_addr = NULL;
-        uint8_t instr = *info;
-        info++;
 
-        if (params_count < i) {
-            log_error("Callback parameters count mismatch. Only expecting"
-                " %d parameters.", params_count);
-        }
-        switch (instr) {
+        switch (op->type) {
             case ARG_VALUE:
-                if (*len - call_len < sizeof(cell)) {
-                    log_error("Callback buffer too small.");
-                    return 0;
-                }
-                memcpy(buf + call_len, params + i + 1, sizeof(cell));
-                call_len += sizeof(cell);
+                size = op->arg * sizeof(cell);
+                memcpy(buf + call_len, params + op->param + 1, size);
+                call_len += size;
                 break;
             case ARG_STRING:
-                amx_GetAddr(amx, params[i + 1], &val_addr);
-                if (val_addr == NULL) {
-                    val_len = 0;
+                amx_GetAddr(amx, params[op->param + 1], &val_addr);
+
+                if (val_addr != NULL && !simd_is_packed(val_addr)) {
+                    /* find the terminator and narrow in a single pass */
+                    uint32_t narrow_len = simd_narrow_cells(val_addr,
+                        (char *)buf + call_len, available);
+
+                    if (narrow_len == SIMD_NOT_TERMINATED) {
+                        *len = measure_call_buffer(amx, plan, params,
+                            name_len);
+                        return false;
+                    }
+
+                    call_len += narrow_len + 1;
+                    break;
                 }
-                else {
+
+                if (val_addr != NULL) {
                     amx_StrLen(val_addr, &val_len);
                 }
 
-                if ((int)*len - (int)call_len < val_len + 1) {
-                    log_error("Callback buffer too small.");
-                    return 0;
+                if ((uint32_t)val_len + 1 > available) {
+                    *len = measure_call_buffer(amx, plan, params, name_len);
+                    return false;
                 }
 
                 if (val_len) {
                     amx_GetString((char *)buf + call_len, val_addr, 0,
-                        *len - call_len);
+                        available);
                 }
                 buf[call_len + val_len] = 0;
                 call_len += val_len + 1;
                 break;
             case ARG_ARRAY:
-                val_len = *(int *)info; /* index of value length */
-                info += sizeof(uint32_t);
+                val_len = params[op->arg + 1];
+                amx_GetAddr(amx, params[op->param + 1], &val_addr);
 
-                if (val_len >= (int)params_count) {
-                    log_error("Invalid callback array size indicator %d.", 
-                        val_len);
-                    return 0;
+                if (val_len < 0 || val_addr == NULL) {
+                    val_len = 0;
                 }
 
-                val_len = params[val_len + 1];
-                amx_GetAddr(amx, params[i + 1], &val_addr);
+                if ((uint32_t)val_len > (available - sizeof(int)) /
+                    sizeof(cell)) {
+                    *len = measure_call_buffer(amx, plan, params, name_len);
+                    return false;
+                }
 
                 /* length */
                 memcpy(buf + call_len, &val_len, sizeof(int));
                 call_len += sizeof(int);
 
                 /* values */
-                for (int j = 0; j < val_len; j++) {
-                    memcpy(buf + call_len, val_addr + j, sizeof(cell));
-                    call_len += sizeof(cell);
+                size = val_len * sizeof(cell);
+                if (size) {
+                    memcpy(buf + call_len, val_addr, size);
+                    call_len += size;
                 }
                 break;
-            default:
-                log_error("Invalid callback instruction %d.", instr);
-                return false;
         }
     }
 
-    if (params[0] / sizeof(cell) != i) {
-        log_error("Callback parameters count mismatch. Expecting %d but "
-            "received %d parameters.", params_count, i);
-    }
-
     *len = call_len;
     return true;
 }
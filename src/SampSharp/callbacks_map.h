@@ -17,19 +17,70 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include <inttypes.h>
 #include <sampgdk/sampgdk.h>
+#include "callback_filter.h"
 
 class remote_server;
 
+/** a step of a compiled callback descriptor */
+struct callback_op {
+    uint8_t type;
+    /** index of the first parameter of the step */
+    uint16_t param;
+    /** number of consecutive values, or index of the array length */
+    uint16_t arg;
+    /** fixed size in bytes of the steps after this one */
+    uint32_t reserve;
+};
+
+/** a callback descriptor compiled into copy steps */
+struct callback_plan {
+    std::vector<callback_op> ops;
+    /** identifier of the callback, or -1 if not registered */
+    int32_t id;
+    /** number of parameters the callback expects */
+    uint32_t params;
+    /** fixed size in bytes of a call, excluding the name */
+    uint32_t fixed_len;
+};
+
 class callbacks_map
 {
 public:
     callbacks_map();
     void clear();
-    void register_buffer(uint8_t *buf);
+    /** removes the filters of all callbacks */
+    void clear_filters();
+    /** registers a callback; returns the identifier of the callback or -1 if
+     * the buffer is invalid */
+    int32_t register_buffer(uint8_t *buf);
+    /** returns the identifier of a registered callback or -1 */
+    int32_t id(const char *name) const;
+    /** returns the number of parameters of a callback */
+    uint32_t param_count(const char *name) const;
+    /** sets the filter of a callback; a filter without predicates removes
+     * the filter */
+    void register_filter(const uint8_t *buf, uint32_t len);
+    /** a value indicating whether a call passes the filter of its callback;
+     * if it does not, retval is set to the default return value */
+    bool accepts(AMX *amx, const char *name, cell *params, cell *retval);
+    /** fills the buffer with the call to the callback; if the buffer is too
+     * small, false is returned and len is set to the required length */
     bool fill_call_buffer(AMX *amx, const char *name, cell *params, 
         uint8_t *buf, uint32_t *len, bool include_name);
+    /** fills the buffer with a call to the callback with zero values, empty
+     * strings and empty arrays; if the buffer is too small, false is
+     * returned and len is set to the required length */
+    bool fill_dry_run_buffer(const char *name, uint8_t *buf, uint32_t *len,
+        bool include_name) const;
+    /** gets the names of the registered callbacks */
+    void registered(std::vector<std::string> &names) const;
 private:
-    std::map<std::string, uint8_t*> callbacks_;
+    uint32_t measure_call_buffer(AMX *amx, const callback_plan &plan,
+        cell *params, uint32_t name_len);
+    std::map<std::string, callback_plan> callbacks_;
+    int32_t next_id_ = 0;
+    std::map<std::string, callback_filter> filters_;
 };
@@ -0,0 +1,35 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+/* capability flags exchanged during the announcement handshake. a feature is
+ * only used during a session if both the plugin and the client have set its
+ * flag; clients which do not reply to the announcement get CAP_NONE.
+ */
+#define CAP_NONE                (0)
+#define CAP_CHUNKED_FRAMES      (1 << 0) /* frames larger than max frame size */
+#define CAP_COMPRESSION         (1 << 1) /* compressed frame payloads */
+#define CAP_BATCHING            (1 << 2) /* multiple natives in one frame */
+#define CAP_ASYNC_CALLBACKS     (1 << 3) /* callbacks without a response */
+#define CAP_SHARED_MEMORY       (1 << 4) /* shared memory transport */
+#define CAP_DRY_RUN_CALLS       (1 << 5) /* public calls marked as dry runs */
+
+/* compression methods */
+#define COMPRESSION_NONE        (0)
+
+/* capabilities supported by this plugin build */
+#define PLUGIN_CAPABILITIES     (CAP_CHUNKED_FRAMES | CAP_DRY_RUN_CALLS)
+#define PLUGIN_COMPRESSION      (COMPRESSION_NONE)
@@ -16,5 +16,5 @@
 #pragma once
 
 enum cmd_status {
-    conn_dead, handled, unhandled, no_cmd
+    conn_dead, handled, unhandled, no_cmd, too_small
 };
@@ -45,7 +45,8 @@ public:
     virtual void disconnect() = 0;
     /** send command to server */
     virtual bool send(uint8_t cmd, uint32_t len, uint8_t *buf) = 0;
-    /** receive command from server */
+    /** receive command from server; returns too_small and sets len to the
+     * required length if the command does not fit the buffer */
     virtual cmd_status receive(uint8_t *command, uint8_t *buf, uint32_t *len)
         = 0;
 };
@@ -24,9 +24,10 @@
 #include <vector>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include "pathutil.h"
 #include "logging.h"
-#include "json.h"
+#include "json_reader.h"
 #if SAMPSHARP_LINUX
 #  include <dirent.h>
 #  include <dlfcn.h>
@@ -45,8 +46,9 @@
 #  define PATH_MAX MAX_PATH
 #endif
 
-#define JSON_IS(obj, type) (obj.JSONType() == json::JSON::Class::type)
-#define JSON_KEY_IS(obj, key, type) (obj.hasKey(key) && JSON_IS(obj[key], type))
+#define TPA_CACHE_MAGIC "SampSharp TPA cache 1"
+#define TPA_CACHE_EXTENSION ".tpa.cache"
+
 
 #if SAMPSHARP_LINUX
 bool coreclr_app::load_symbol(void *coreclr_lib, const char *symbol,
@@ -73,6 +75,13 @@ int coreclr_app::initialize(const char *clr_dir_c, const char* exe_path,
 
     abs_exe_path_ = abs_exe_path;
 
+    if(aot_) {
+        return initialize_aot();
+    }
+    if(!hostfxr_path_.empty()) {
+        return initialize_hostfxr();
+    }
+
     std::string app_dir;
     if(!get_directory(abs_exe_path.c_str(), app_dir)) {
         log_error("Failed to get app path.");
@@ -95,14 +104,7 @@ int coreclr_app::initialize(const char *clr_dir_c, const char* exe_path,
         return -1;
     }
 
-    // Construct tpa
-    std::string tpa_list;
-
-    tpa_list = abs_exe_path;
-    tpa_list.append(TPA_DELIMITER);
-
-    construct_tpa(clr_dir.c_str(), tpa_list);
-    add_deps_to_tpa(abs_exe_path, tpa_list);
+    timer_.mark("paths");
 
     // Construct native search directory paths
     std::string plugins_dir;
@@ -113,6 +115,34 @@ int coreclr_app::initialize(const char *clr_dir_c, const char* exe_path,
     native_search_dirs.append(TPA_DELIMITER);
     native_search_dirs.append(plugins_dir);
 
+    // Construct tpa; reuse the list of a previous start if its inputs did
+    // not change
+    std::string tpa_list;
+    std::string tpa_cache_path;
+    std::string tpa_key;
+
+    path_change_extension(abs_exe_path.c_str(), TPA_CACHE_EXTENSION,
+        tpa_cache_path);
+    tpa_cache_key(clr_dir, abs_exe_path, native_search_dirs, tpa_key);
+
+    bool tpa_cached = read_tpa_cache(tpa_cache_path, tpa_key, tpa_list);
+    if (!tpa_cached) {
+        tpa_list = abs_exe_path;
+        tpa_list.append(TPA_DELIMITER);
+
+        construct_tpa(clr_dir.c_str(), tpa_list);
+        add_deps_to_tpa(abs_exe_path, tpa_list);
+
+        write_tpa_cache(tpa_cache_path, tpa_key, tpa_list);
+    }
+
+    timer_.mark(tpa_cached ? "tpa (cached)" : "tpa");
+
+    std::map<std::string, std::string> properties;
+    merge_properties(abs_exe_path, properties);
+
+    timer_.mark("properties");
+
 #if SAMPSHARP_LINUX
     module_ = dlopen(coreclr_dll.c_str(), RTLD_NOW | RTLD_LOCAL);
 
@@ -138,38 +168,39 @@ int coreclr_app::initialize(const char *clr_dir_c, const char* exe_path,
         return -1;
     }
 
-    const char *property_keys[] = {
-        "TRUSTED_PLATFORM_ASSEMBLIES",
-        "APP_PATHS",
-        "APP_NI_PATHS",
-        "NATIVE_DLL_SEARCH_DIRECTORIES",
-        "System.GC.Server",
-        "System.Globalization.Invariant",
-    };
-    const char *property_values[] = {
-        // TRUSTED_PLATFORM_ASSEMBLIES
-        tpa_list.c_str(),
-        // APP_PATHS
-        app_dir.c_str(),
-        // APP_NI_PATHS
-        app_dir.c_str(),
-        // NATIVE_DLL_SEARCH_DIRECTORIES
-        native_search_dirs.c_str(),
-        // System.GC.Server
-        "false",
-        // System.Globalization.Invariant
-        "false",
-    };
-
-    return coreclr_initialize_(
+    timer_.mark("load");
+
+    /* the paths are set by the host; other properties follow */
+    std::vector<const char *> property_keys;
+    std::vector<const char *> property_values;
+
+    property_keys.push_back("TRUSTED_PLATFORM_ASSEMBLIES");
+    property_values.push_back(tpa_list.c_str());
+    property_keys.push_back("APP_PATHS");
+    property_values.push_back(app_dir.c_str());
+    property_keys.push_back("APP_NI_PATHS");
+    property_values.push_back(app_dir.c_str());
+    property_keys.push_back("NATIVE_DLL_SEARCH_DIRECTORIES");
+    property_values.push_back(native_search_dirs.c_str());
+
+    for (std::map<std::string, std::string>::const_iterator it =
+        properties.begin(); it != properties.end(); it++) {
+        property_keys.push_back(it->first.c_str());
+        property_values.push_back(it->second.c_str());
+    }
+
+    int retval = coreclr_initialize_(
         abs_exe_path.c_str(),
         app_domain_friendly_name,
-        sizeof(property_keys) / sizeof(property_keys[0]),
-        property_keys,
-        property_values,
+        (int)property_keys.size(),
+        property_keys.data(),
+        property_values.data(),
         &host_,
         &domain_id_
     );
+
+    timer_.mark("initialize");
+    return retval;
 #elif SAMPSHARP_WINDOWS
     std::wstring wapp_dir = std::wstring(app_dir.begin(), app_dir.end());
     std::wstring wclr_dir = std::wstring(clr_dir.begin(), clr_dir.end());
@@ -205,12 +236,23 @@ int coreclr_app::initialize(const char *clr_dir_c, const char* exe_path,
 	}
 
 
+    // The GC flags follow the runtime properties
+    int gc_flags = 0;
+    std::map<std::string, std::string>::const_iterator gc_property;
+    if ((gc_property = properties.find("System.GC.Server")) !=
+        properties.end() && gc_property->second == "true") {
+        gc_flags |= STARTUP_SERVER_GC;
+    }
+    if ((gc_property = properties.find("System.GC.Concurrent")) ==
+        properties.end() || gc_property->second != "false") {
+        gc_flags |= STARTUP_CONCURRENT_GC;
+    }
+
     hr = host_->SetStartupFlags(
 		static_cast<STARTUP_FLAGS>(
-			// STARTUP_SERVER_GC |								// Use server GC
 			// STARTUP_LOADER_OPTIMIZATION_MULTI_DOMAIN |		// Maximize domain-neutral loading
 			// STARTUP_LOADER_OPTIMIZATION_MULTI_DOMAIN_HOST |	// Domain-neutral loading for strongly-named assemblies
-			STARTUP_CONCURRENT_GC |						// Use concurrent GC
+			gc_flags |
 			STARTUP_SINGLE_APPDOMAIN |					// All code executes in the default AppDomain
 																		// (required to use the runtimeHost->ExecuteAssembly helper function)
 			STARTUP_LOADER_OPTIMIZATION_SINGLE_DOMAIN	// Prevents domain-neutral loading
@@ -223,6 +265,8 @@ int coreclr_app::initialize(const char *clr_dir_c, const char* exe_path,
 		return -1;
 	}
 
+    timer_.mark("load");
+
 	// Starting the runtime will initialize the JIT, GC, loader, etc.
 	hr = host_->Start();
 	if (FAILED(hr))
@@ -261,6 +305,25 @@ int coreclr_app::initialize(const char *clr_dir_c, const char* exe_path,
 		L"UseLatestBehaviorWhenTFMNotSpecified"
 	};
 
+    std::vector<std::wstring> wproperty_keys;
+    std::vector<std::wstring> wproperty_values;
+    std::vector<const wchar_t *> property_keys(propertyKeys,
+        propertyKeys + sizeof(propertyKeys) / sizeof(wchar_t*));
+    std::vector<const wchar_t *> property_values(propertyValues,
+        propertyValues + sizeof(propertyValues) / sizeof(wchar_t*));
+
+    for (std::map<std::string, std::string>::const_iterator it =
+        properties.begin(); it != properties.end(); it++) {
+        wproperty_keys.push_back(std::wstring(it->first.begin(),
+            it->first.end()));
+        wproperty_values.push_back(std::wstring(it->second.begin(),
+            it->second.end()));
+    }
+    for (size_t i = 0; i < wproperty_keys.size(); i++) {
+        property_keys.push_back(wproperty_keys[i].c_str());
+        property_values.push_back(wproperty_values[i].c_str());
+    }
+
 
 	// Create the AppDomain
 	hr = host_->CreateAppDomainWithManager(
@@ -268,9 +331,9 @@ int coreclr_app::initialize(const char *clr_dir_c, const char* exe_path,
 		app_domain_flags,
 		nullptr,
 		nullptr,
-		sizeof(propertyKeys)/sizeof(wchar_t*),
-		propertyKeys,
-		propertyValues,
+		(int)property_keys.size(),
+		property_keys.data(),
+		property_values.data(),
 		&domain_id_);
 
 	if (FAILED(hr))
@@ -279,10 +342,250 @@ int coreclr_app::initialize(const char *clr_dir_c, const char* exe_path,
 		return -1;
 	}
 
+    timer_.mark("initialize");
     return 0;
 #endif
 }
 
+/* named sets of runtime properties; pairs of keys and values */
+static const char * const profile_low_latency[] = {
+    "System.GC.Server", "false",
+    "System.GC.Concurrent", "true",
+    "System.GC.RetainVM", "true",
+    "System.Runtime.TieredPGO", "false",
+    "System.Runtime.TieredCompilation.QuickJitForLoops", "true",
+    NULL
+};
+
+static const char * const profile_throughput[] = {
+    "System.GC.Server", "true",
+    "System.GC.Concurrent", "false",
+    "System.Runtime.TieredPGO", "true",
+    "System.Runtime.TieredCompilation.QuickJitForLoops", "true",
+    NULL
+};
+
+static const struct {
+    const char *name;
+    const char * const *properties;
+} profiles[] = {
+    { "low-latency", profile_low_latency },
+    { "throughput", profile_throughput },
+};
+
+/** returns true if the property is set by the host */
+static bool is_host_property(const std::string &key) {
+    return key == "TRUSTED_PLATFORM_ASSEMBLIES" ||
+        key == "APP_PATHS" ||
+        key == "APP_NI_PATHS" ||
+        key == "NATIVE_DLL_SEARCH_DIRECTORIES" ||
+        key == "PLATFORM_RESOURCE_ROOTS" ||
+        key == "AppDomainCompatSwitch";
+}
+
+bool coreclr_app::set_profile(const char *name) {
+    for (size_t i = 0; i < sizeof(profiles) / sizeof(profiles[0]); i++) {
+        if (strcmp(profiles[i].name, name)) {
+            continue;
+        }
+
+        for (const char * const *p = profiles[i].properties; *p; p += 2) {
+            properties_[p[0]] = p[1];
+        }
+        return true;
+    }
+
+    return false;
+}
+
+void coreclr_app::set_property(const std::string &key,
+    const std::string &value) {
+    properties_[key] = value;
+}
+
+void coreclr_app::set_hostfxr(const char *path) {
+    hostfxr_path_ = path ? path : "";
+}
+
+void coreclr_app::set_aot(bool aot) {
+    aot_ = aot;
+}
+
+/* the managed function which runs the entry point of the app when hosted
+ * through hostfxr or exported by a NativeAOT compiled app */
+#define EXECUTE_LIB "SampSharp.Core"
+#define EXECUTE_CLASS EXECUTE_LIB ".Hosting.Interop"
+#define EXECUTE_METHOD "Execute"
+
+/* prefix of the functions exported by a NativeAOT compiled app */
+#define AOT_EXPORT_PREFIX "SampSharp"
+
+typedef int32_t (CORECLR_CALL *execute_ptr)(const char **argv, int32_t argc);
+
+#if SAMPSHARP_LINUX
+static std::string to_char_t(const std::string &value) {
+    return value;
+}
+#elif SAMPSHARP_WINDOWS
+static std::wstring to_char_t(const std::string &value) {
+    return std::wstring(value.begin(), value.end());
+}
+#endif
+
+static void *find_symbol(module_t module, const char *symbol) {
+#if SAMPSHARP_LINUX
+    return dlsym(module, symbol);
+#elif SAMPSHARP_WINDOWS
+    return (void *)::GetProcAddress(module, symbol);
+#endif
+}
+
+static void *module_symbol(module_t module, const char *symbol) {
+    void *ptr = find_symbol(module, symbol);
+    if(!ptr) {
+        log_error("Function %s not found in " HOSTFXR_LIB ".", symbol);
+    }
+    return ptr;
+}
+
+int coreclr_app::initialize_hostfxr() {
+    std::string hostfxr_lib(hostfxr_path_);
+    if(dir_exists(hostfxr_path_.c_str())) {
+        path_append(hostfxr_path_.c_str(), HOSTFXR_LIB, hostfxr_lib);
+    }
+
+    /* hostfxr resolves the framework and reads the configProperties of the
+     * runtime config itself */
+    std::string runtimeconfig_path;
+    path_change_extension(abs_exe_path_.c_str(), ".runtimeconfig.json",
+        runtimeconfig_path);
+
+    if(!file_exists(runtimeconfig_path.c_str())) {
+        log_error("Runtime config %s could not be found.",
+            runtimeconfig_path.c_str());
+        return -1;
+    }
+
+    timer_.mark("paths");
+
+#if SAMPSHARP_LINUX
+    hostfxr_module_ = dlopen(hostfxr_lib.c_str(), RTLD_NOW | RTLD_LOCAL);
+#elif SAMPSHARP_WINDOWS
+    hostfxr_module_ = LoadLibraryExA(hostfxr_lib.c_str(), nullptr, 0);
+#endif
+
+    if(!hostfxr_module_) {
+        log_error("Failed to load hostfxr library %s.", hostfxr_lib.c_str());
+        return -1;
+    }
+
+    hostfxr_initialize_for_runtime_config_fn initialize_for_runtime_config =
+        (hostfxr_initialize_for_runtime_config_fn)module_symbol(
+            hostfxr_module_, "hostfxr_initialize_for_runtime_config");
+    hostfxr_set_runtime_property_value_fn set_runtime_property_value =
+        (hostfxr_set_runtime_property_value_fn)module_symbol(
+            hostfxr_module_, "hostfxr_set_runtime_property_value");
+    hostfxr_get_runtime_property_value_fn get_runtime_property_value =
+        (hostfxr_get_runtime_property_value_fn)module_symbol(
+            hostfxr_module_, "hostfxr_get_runtime_property_value");
+    hostfxr_get_runtime_delegate_fn get_runtime_delegate =
+        (hostfxr_get_runtime_delegate_fn)module_symbol(
+            hostfxr_module_, "hostfxr_get_runtime_delegate");
+    hostfxr_close_fn close = (hostfxr_close_fn)module_symbol(
+        hostfxr_module_, "hostfxr_close");
+
+    if(!initialize_for_runtime_config || !set_runtime_property_value ||
+        !get_runtime_property_value || !get_runtime_delegate || !close) {
+        return -1;
+    }
+
+    timer_.mark("load");
+
+    hostfxr_handle context = NULL;
+    int32_t retval = initialize_for_runtime_config(
+        to_char_t(runtimeconfig_path).c_str(), NULL, &context);
+
+    if(retval < 0 || !context) {
+        log_error("Failed to initialize hostfxr. Error %x.", retval);
+        if(context) {
+            close(context);
+        }
+        return -1;
+    }
+
+    /* the game mode imports functions from the plugins */
+    std::string plugins_dir;
+    get_absolute_path("plugins", plugins_dir);
+
+    const char_t *search_dirs = NULL;
+    auto native_search_dirs = to_char_t(plugins_dir);
+    if(get_runtime_property_value(context,
+        to_char_t("NATIVE_DLL_SEARCH_DIRECTORIES").c_str(),
+        &search_dirs) >= 0 && search_dirs && *search_dirs) {
+        native_search_dirs = search_dirs + to_char_t(TPA_DELIMITER) +
+            native_search_dirs;
+    }
+
+    set_runtime_property_value(context,
+        to_char_t("NATIVE_DLL_SEARCH_DIRECTORIES").c_str(),
+        native_search_dirs.c_str());
+
+    for (std::map<std::string, std::string>::const_iterator it =
+        properties_.begin(); it != properties_.end(); it++) {
+        if(is_host_property(it->first)) {
+            log_warning("Runtime property %s is set by the host.",
+                it->first.c_str());
+            continue;
+        }
+
+        if(set_runtime_property_value(context, to_char_t(it->first).c_str(),
+            to_char_t(it->second).c_str()) < 0) {
+            log_warning("Failed to set runtime property %s.",
+                it->first.c_str());
+        }
+    }
+
+    timer_.mark("properties");
+
+    /* loads the runtime */
+    retval = get_runtime_delegate(context,
+        hdt_load_assembly_and_get_function_pointer, (void **)&load_assembly_);
+    close(context);
+
+    timer_.mark("initialize");
+
+    if(retval < 0 || !load_assembly_) {
+        log_error("Failed to load the runtime. Error %x.", retval);
+        load_assembly_ = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+int coreclr_app::initialize_aot() {
+    /* the runtime is compiled into the library; there is no JIT to start */
+#if SAMPSHARP_LINUX
+    aot_module_ = dlopen(abs_exe_path_.c_str(), RTLD_NOW | RTLD_LOCAL);
+#elif SAMPSHARP_WINDOWS
+    aot_module_ = LoadLibraryExA(abs_exe_path_.c_str(), nullptr, 0);
+#endif
+
+    timer_.mark("load");
+
+    if(!aot_module_) {
+#if SAMPSHARP_LINUX
+        log_error("Failed to load game mode library: %s.", dlerror());
+#elif SAMPSHARP_WINDOWS
+        log_error("Failed to load game mode library %s.",
+            abs_exe_path_.c_str());
+#endif
+        return -1;
+    }
+
+    return 0;
+}
+
 int coreclr_app::construct_tpa(const char *directory, std::string &tpa_list) {
 #if SAMPSHARP_LINUX
     const char * const tpaExtensions[] = {
@@ -413,14 +716,51 @@ int coreclr_app::construct_tpa(const char *directory, std::string &tpa_list) {
     return 0;
 }
 
-void coreclr_app::add_deps_to_tpa(std::string abs_exe_path,
-    std::string &tpa_list) {
-    if(!path_has_extension(abs_exe_path.c_str(), ".dll")) {
-        return;
+/** computes the FNV-1a hash of the contents of a file */
+static uint64_t hash_file(const char *path) {
+    uint64_t hash = 14695981039346656037ULL;
+    char buf[1024 * 16];
+    size_t len;
+
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return 0;
     }
 
-    std::string runtimeconfig_path;
-    std::string deps_path;
+    while ((len = fread(buf, 1, sizeof(buf), file)) > 0) {
+        for (size_t i = 0; i < len; i++) {
+            hash = (hash ^ (uint8_t)buf[i]) * 1099511628211ULL;
+        }
+    }
+
+    fclose(file);
+    return hash;
+}
+
+/** reads the contents of a file */
+static bool read_file(const char *path, std::vector<char> &contents) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long len = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    contents.resize(len > 0 ? (size_t)len : 0);
+    bool ok = len >= 0 &&
+        fread(contents.data(), 1, contents.size(), file) == contents.size();
+
+    fclose(file);
+    return ok;
+}
+
+bool coreclr_app::find_deps_files(const std::string &abs_exe_path,
+    std::string &runtimeconfig_path, std::string &deps_path) {
+    if(!path_has_extension(abs_exe_path.c_str(), ".dll")) {
+        return false;
+    }
 
     // Find runtime config
     path_change_extension(abs_exe_path.c_str(), ".runtimeconfig.dev.json",
@@ -432,113 +772,292 @@ void coreclr_app::add_deps_to_tpa(std::string abs_exe_path,
     }
 
     if(!file_exists(runtimeconfig_path.c_str())) {
-        return;
+        return false;
     }
 
     // Find deps file
     path_change_extension(abs_exe_path.c_str(), ".deps.json", deps_path);
-    if(!file_exists(deps_path.c_str())) {
+    return file_exists(deps_path.c_str());
+}
+
+void coreclr_app::tpa_cache_key(const std::string &clr_dir,
+    const std::string &abs_exe_path, const std::string &native_search_dirs,
+    std::string &key) {
+    /* the list depends on the files in the runtime directory and the
+     * packages listed in the deps file */
+    char buf[64];
+    uint64_t mtime = 0;
+    std::string runtimeconfig_path;
+    std::string deps_path;
+
+    path_mtime(clr_dir.c_str(), &mtime);
+    sampsharp_sprintf(buf, sizeof(buf), "%llu", (unsigned long long)mtime);
+
+    key = clr_dir;
+    key.append("@");
+    key.append(buf);
+    key.append(TPA_DELIMITER);
+    key.append(abs_exe_path);
+    key.append(TPA_DELIMITER);
+    key.append(native_search_dirs);
+
+    if (find_deps_files(abs_exe_path, runtimeconfig_path, deps_path)) {
+        sampsharp_sprintf(buf, sizeof(buf), "#%llx#%llx",
+            (unsigned long long)hash_file(runtimeconfig_path.c_str()),
+            (unsigned long long)hash_file(deps_path.c_str()));
+        key.append(buf);
+    }
+}
+
+bool coreclr_app::read_tpa_cache(const std::string &path,
+    const std::string &key, std::string &tpa_list) {
+    std::ifstream stream(path);
+    std::string magic, cached_key;
+
+    if (!stream ||
+        !std::getline(stream, magic) || magic != TPA_CACHE_MAGIC ||
+        !std::getline(stream, cached_key) || cached_key != key ||
+        !std::getline(stream, tpa_list) || tpa_list.empty()) {
+        tpa_list.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void coreclr_app::write_tpa_cache(const std::string &path,
+    const std::string &key, const std::string &tpa_list) {
+    /* write a temporary file and move it over the cache so a concurrent
+     * start never reads a partial cache */
+    std::string tmp_path(path);
+    tmp_path.append(".tmp");
+
+    std::ofstream stream(tmp_path, std::ios::trunc);
+    if (!stream) {
+        log_debug("Failed to write TPA cache %s.", path.c_str());
         return;
     }
 
-    log_debug("runtimeconfig path: %s", runtimeconfig_path.c_str());
-    log_debug("deps path: %s", deps_path.c_str());
+    stream << TPA_CACHE_MAGIC << "\n" << key << "\n" << tpa_list << "\n";
+    stream.close();
 
-    // Read files
-    std::ifstream runtimeconfig_stream(runtimeconfig_path);
-    std::string runtimeconfig_json;
+    if (!stream || !file_replace(tmp_path.c_str(), path.c_str())) {
+        log_debug("Failed to write TPA cache %s.", path.c_str());
+        remove(tmp_path.c_str());
+    }
+}
 
-    runtimeconfig_stream.seekg(0, std::ios::end);   
-    runtimeconfig_json.reserve((size_t)runtimeconfig_stream.tellg());
-    runtimeconfig_stream.seekg(0, std::ios::beg);
+void coreclr_app::merge_properties(const std::string &abs_exe_path,
+    std::map<std::string, std::string> &properties) {
+    std::string runtimeconfig_path;
+    std::string deps_path;
+    std::vector<char> runtimeconfig_json;
+    std::string key, value;
+
+    properties["System.GC.Server"] = "false";
+    properties["System.Globalization.Invariant"] = "false";
+
+    /* the deps file is not required for the runtime config */
+    find_deps_files(abs_exe_path, runtimeconfig_path, deps_path);
+
+    if(!runtimeconfig_path.empty() &&
+        read_file(runtimeconfig_path.c_str(), runtimeconfig_json)) {
+        json_reader runtimeconfig(runtimeconfig_json.data(),
+            runtimeconfig_json.size());
+
+        if(runtimeconfig.find("runtimeOptions") &&
+            runtimeconfig.find("configProperties") &&
+            runtimeconfig.begin_object()) {
+            while(runtimeconfig.next_key(key)) {
+                if(!runtimeconfig.read_scalar(value)) {
+                    runtimeconfig.skip();
+                    continue;
+                }
 
-    runtimeconfig_json.assign(
-        std::istreambuf_iterator<char>(runtimeconfig_stream),
-        std::istreambuf_iterator<char>());
+                properties[key] = value;
+            }
+        }
+    }
 
-    runtimeconfig_stream.close();
+    for (std::map<std::string, std::string>::const_iterator it =
+        properties_.begin(); it != properties_.end(); it++) {
+        properties[it->first] = it->second;
+    }
 
-    std::ifstream deps_stream(deps_path);
-    std::string deps_json;
+    for (std::map<std::string, std::string>::iterator it =
+        properties.begin(); it != properties.end();) {
+        if (is_host_property(it->first)) {
+            log_warning("Runtime property %s is set by the host.",
+                it->first.c_str());
+            it = properties.erase(it);
+            continue;
+        }
 
-    deps_stream.seekg(0, std::ios::end);   
-    deps_json.reserve((size_t)deps_stream.tellg());
-    deps_stream.seekg(0, std::ios::beg);
+        log_debug("Runtime property %s = %s", it->first.c_str(),
+            it->second.c_str());
+        it++;
+    }
+}
 
-    deps_json.assign(
-        std::istreambuf_iterator<char>(deps_stream),
-        std::istreambuf_iterator<char>());
+void coreclr_app::add_deps_to_tpa(std::string abs_exe_path,
+    std::string &tpa_list) {
+    std::string runtimeconfig_path;
+    std::string deps_path;
 
-    deps_stream.close();
+    if(!find_deps_files(abs_exe_path, runtimeconfig_path, deps_path)) {
+        return;
+    }
+
+    log_debug("runtimeconfig path: %s", runtimeconfig_path.c_str());
+    log_debug("deps path: %s", deps_path.c_str());
+
+    // Read files
+    std::vector<char> runtimeconfig_json;
+    std::vector<char> deps_json;
+
+    if(!read_file(runtimeconfig_path.c_str(), runtimeconfig_json) ||
+        !read_file(deps_path.c_str(), deps_json)) {
+        return;
+    }
 
     // Find probing paths
-    json::JSON runtimeconfig = json::JSON::Load(runtimeconfig_json);
+    json_reader runtimeconfig(runtimeconfig_json.data(),
+        runtimeconfig_json.size());
+    std::vector<std::string> probing_paths;
+    std::string key, value;
 
-    if(!runtimeconfig.hasKey("runtimeOptions") ||
-        !runtimeconfig["runtimeOptions"].hasKey("additionalProbingPaths")) {
+    if(!runtimeconfig.find("runtimeOptions") ||
+        !runtimeconfig.find("additionalProbingPaths") ||
+        runtimeconfig.peek() != '[') {
         return;
     }
 
-    json::JSON probes =
-        runtimeconfig["runtimeOptions"]["additionalProbingPaths"];
+    runtimeconfig.begin_array();
+    while(runtimeconfig.next_element()) {
+        if(!runtimeconfig.read_string(value)) {
+            runtimeconfig.skip();
+            continue;
+        }
+
+        if(dir_exists(value.c_str())) {
+            probing_paths.push_back(value);
+
+            log_debug("Probe path found: %s", value.c_str());
+        }
+    }
+
+    // Find the members of the deps file without reading the entries of
+    // other targets
+    json_reader deps(deps_json.data(), deps_json.size());
+    std::string target_name;
+    size_t
+        runtime_target_pos = 0,
+        targets_pos = 0,
+        libraries_pos = 0;
 
-    if(!JSON_IS(probes, Array)) {
+    if(!deps.begin_object()) {
         return;
     }
 
-    std::vector<std::string> probing_paths;
-    for(const auto& path_obj : probes.ArrayRange()) {
-        std::string path = path_obj.ToString();
-        if(dir_exists(path.c_str())) {
-            probing_paths.push_back(path);
+    while(deps.next_key(key)) {
+        if(key == "runtimeTarget") {
+            runtime_target_pos = deps.position();
+        }
+        else if(key == "targets") {
+            targets_pos = deps.position();
+        }
+        else if(key == "libraries") {
+            libraries_pos = deps.position();
+        }
 
-            log_debug("Probe path found: %s", path.c_str());
+        if(!deps.skip()) {
+            return;
         }
     }
 
-    // Find dependencies
-    json::JSON deps = json::JSON::Load(deps_json);
+    if(!runtime_target_pos || !targets_pos || !libraries_pos) {
+        return;
+    }
 
-    if(!JSON_KEY_IS(deps, "runtimeTarget", Object) ||
-        !JSON_KEY_IS(deps, "targets", Object) ||
-        !JSON_KEY_IS(deps, "libraries", Object) ||
-        !JSON_KEY_IS(deps["runtimeTarget"], "name", String)) {
+    deps.seek(runtime_target_pos);
+    if(!deps.find("name") || !deps.read_string(target_name)) {
         return;
     }
 
-    std::string target_name = deps["runtimeTarget"]["name"].ToString();
+    // Find the paths of packages
+    std::unordered_map<std::string, std::string> package_paths;
+    std::string type, path;
 
-    if(!deps["targets"].hasKey(target_name)) {
+    deps.seek(libraries_pos);
+    if(!deps.begin_object()) {
         return;
     }
 
-    json::JSON target = deps["targets"][target_name];
+    while(deps.next_key(key)) {
+        if(deps.peek() != '{') {
+            deps.skip();
+            continue;
+        }
+
+        type.clear();
+        path.clear();
+
+        deps.begin_object();
+        while(deps.next_key(value)) {
+            if(value == "type" && deps.read_string(type)) {
+                continue;
+            }
+            if(value == "path" && deps.read_string(path)) {
+                continue;
+            }
+            deps.skip();
+        }
+
+        if(type == "package" && !path.empty()) {
+            package_paths[key] = path;
+        }
+    }
+
+    // Find dependencies
+    deps.seek(targets_pos);
+    if(!deps.find(target_name.c_str())) {
+        return;
+    }
 
-    for(auto obj : target.ObjectRange()) {
-        if(!JSON_IS(obj.second, Object) ||
-            !JSON_KEY_IS(obj.second, "runtime", Object) ||
-            !JSON_KEY_IS(deps["libraries"], obj.first, Object) ||
-            !JSON_KEY_IS(deps["libraries"][obj.first], "type", String) ||
-            deps["libraries"][obj.first]["type"].ToString() != "package" ||
-            !JSON_KEY_IS(deps["libraries"][obj.first], "path", String)
-            ) {
+    deps.begin_object();
+    while(deps.next_key(key)) {
+        if(deps.peek() != '{') {
+            deps.skip();
             continue;
         }
 
-        std::string lib_path = deps["libraries"][obj.first]["path"].ToString();
-        
+        std::unordered_map<std::string, std::string>::const_iterator lib =
+            package_paths.find(key);
+
+        deps.begin_object();
+        while(deps.next_key(value)) {
+            if(value != "runtime" || lib == package_paths.end() ||
+                deps.peek() != '{') {
+                deps.skip();
+                continue;
+            }
+
+            deps.begin_object();
+            while(deps.next_key(path)) {
+                deps.skip();
 
-        for(const auto& runtime_obj : obj.second["runtime"].ObjectRange()) {
-            for(const auto& probing_path : probing_paths) {
-                std::string path;
-                path_append(probing_path.c_str(), lib_path.c_str(), path);
-                path_append(path.c_str(), runtime_obj.first.c_str(), path);
+                for(const auto& probing_path : probing_paths) {
+                    std::string dep_path;
+                    path_append(probing_path.c_str(), lib->second.c_str(),
+                        dep_path);
+                    path_append(dep_path.c_str(), path.c_str(), dep_path);
 
-                if(file_exists(path.c_str())) {
-                    log_debug("Found dependency %s", path.c_str());
+                    if(file_exists(dep_path.c_str())) {
+                        log_debug("Found dependency %s", dep_path.c_str());
 
-                    tpa_list.append(path);
-                    tpa_list.append(TPA_DELIMITER);
+                        tpa_list.append(dep_path);
+                        tpa_list.append(TPA_DELIMITER);
+                    }
                 }
             }
         }
@@ -548,6 +1067,13 @@ void coreclr_app::add_deps_to_tpa(std::string abs_exe_path,
 int coreclr_app::release()
 {
     int retval = -1;
+
+    /* a runtime loaded through hostfxr or compiled into the app can not be
+     * unloaded */
+    if(aot_ || !hostfxr_path_.empty()) {
+        return 0;
+    }
+
 #if SAMPSHARP_LINUX
     if(coreclr_shutdown_) {
         retval = coreclr_shutdown_(host_, domain_id_);
@@ -575,6 +1101,31 @@ int coreclr_app::release()
 
 int coreclr_app::create_delegate(const char* assembly_name,
     const char* type_name, const char* method_name, void** delegate) {
+    if(aot_module_) {
+        std::string symbol(AOT_EXPORT_PREFIX);
+        symbol.append(method_name);
+
+        *delegate = find_symbol(aot_module_, symbol.c_str());
+        return *delegate ? 0 : -1;
+    }
+
+    if(load_assembly_) {
+        /* the delegate type is nested in the type of the method */
+        std::string type(type_name);
+        type.append(", ");
+        type.append(assembly_name);
+
+        std::string delegate_type(type_name);
+        delegate_type.append("+");
+        delegate_type.append(method_name);
+        delegate_type.append("Delegate, ");
+        delegate_type.append(assembly_name);
+
+        return load_assembly_(to_char_t(abs_exe_path_).c_str(),
+            to_char_t(type).c_str(), to_char_t(method_name).c_str(),
+            to_char_t(delegate_type).c_str(), NULL, delegate);
+    }
+
 #if SAMPSHARP_LINUX
     if(!coreclr_create_delegate_) {
         return -1;
@@ -597,6 +1148,24 @@ int coreclr_app::create_delegate(const char* assembly_name,
 }
 
 int coreclr_app::execute_assembly(int argc, const char** argv, unsigned int* exit_code) {
+    if(aot_module_ || load_assembly_) {
+        execute_ptr execute = NULL;
+        int retval;
+
+        if((retval = create_delegate(EXECUTE_LIB, EXECUTE_CLASS,
+            EXECUTE_METHOD, (void **)&execute)) < 0) {
+            return retval;
+        }
+
+        /* the path of the app is passed in front of the arguments */
+        std::vector<const char *> args;
+        args.push_back(abs_exe_path_.c_str());
+        args.insert(args.end(), argv, argv + argc);
+
+        *exit_code = (unsigned int)execute(args.data(), (int32_t)args.size());
+        return 0;
+    }
+
 #if SAMPSHARP_LINUX
     if(!coreclr_execute_assembly_) {
         return -1;
@@ -16,7 +16,10 @@
 #pragma once
 
 #include <string>
+#include <map>
 #include "platforms.h"
+#include "startup_timer.h"
+#include "hostfxr.h"
 #if SAMPSHARP_LINUX
 #  include "coreclrhost.h"
 #elif SAMPSHARP_WINDOWS
@@ -26,10 +29,12 @@
 #if SAMPSHARP_LINUX
 #  define CORECLR_CALL
 #  define CORECLR_LIB "libcoreclr.so"
+#  define HOSTFXR_LIB "libhostfxr.so"
 #  define TPA_DELIMITER ":"
 #elif SAMPSHARP_WINDOWS
 #  define CORECLR_CALL __stdcall
 #  define CORECLR_LIB "coreclr.dll"
+#  define HOSTFXR_LIB "hostfxr.dll"
 #  define TPA_DELIMITER ";"
 #endif
 
@@ -52,16 +57,57 @@ public:
         const char* method_name, void** delegate);
     int execute_assembly(int argc, const char** argv, unsigned int* exit_code);
     int release();
+    /** sets the runtime properties of a named profile; returns false if the
+     * profile does not exist */
+    bool set_profile(const char *name);
+    /** sets a runtime property; overrides the runtime config */
+    void set_property(const std::string &key, const std::string &value);
+    /** hosts the runtime through the hostfxr library at the specified path,
+     * which resolves the runtime using the runtime config of the app */
+    void set_hostfxr(const char *path);
+    /** loads the app as a NativeAOT compiled shared library. delegates are
+     * resolved from the functions the library exports with the name of the
+     * method prefixed by "SampSharp", e.g. SampSharpTick; the entry point is
+     * SampSharpExecute */
+    void set_aot(bool aot);
+    /** the durations of the startup phases */
+    startup_timer &timer() { return timer_; }
 
 private:
     int construct_tpa(const char *directory, std::string &tpa_list);
     void add_deps_to_tpa(std::string abs_exe_path, std::string &tpa_list);
+    bool find_deps_files(const std::string &abs_exe_path,
+        std::string &runtimeconfig_path, std::string &deps_path);
+    /** builds the key which identifies the inputs of the tpa list */
+    void tpa_cache_key(const std::string &clr_dir,
+        const std::string &abs_exe_path,
+        const std::string &native_search_dirs, std::string &key);
+    bool read_tpa_cache(const std::string &path, const std::string &key,
+        std::string &tpa_list);
+    void write_tpa_cache(const std::string &path, const std::string &key,
+        const std::string &tpa_list);
+    /** merges the defaults, the configProperties of the runtime config and
+     * the properties set by the server */
+    void merge_properties(const std::string &abs_exe_path,
+        std::map<std::string, std::string> &properties);
+    int initialize_hostfxr();
+    int initialize_aot();
 
 private:
     std::string abs_exe_path_;
+    /** runtime properties set by the server */
+    std::map<std::string, std::string> properties_;
+    startup_timer timer_;
     host_t *host_ = NULL;
     module_t module_ = NULL;
     domaind_id_t domain_id_ = 0;
+    /** path of the hostfxr library; empty if coreclr is hosted directly */
+    std::string hostfxr_path_;
+    module_t hostfxr_module_ = NULL;
+    load_assembly_and_get_function_pointer_fn load_assembly_ = NULL;
+    /** indicates whether the app is a NativeAOT compiled library */
+    bool aot_ = false;
+    module_t aot_module_ = NULL;
 
 #if SAMPSHARP_LINUX
 private:
@@ -0,0 +1,274 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "entity_snapshot.h"
+#include <string.h>
+#include "logging.h"
+
+entity_snapshot::entity_snapshot() :
+    attributes_(SNAPSHOT_NONE),
+    cur_(NULL),
+    cells_(0),
+    prev_(NULL),
+    prev_cells_(0),
+    frame_(NULL) {
+}
+
+entity_snapshot::~entity_snapshot() {
+    delete[] cur_;
+    delete[] prev_;
+    delete[] frame_;
+}
+
+/** the number of cells per entity for the specified attributes */
+uint32_t entity_snapshot::count_cells(uint32_t attributes) {
+    uint32_t count = 0;
+
+    for (uint32_t bit = 1; bit; bit <<= 1) {
+        if (attributes & bit) {
+            count += bit == SNAPSHOT_PLAYER_POS || bit == SNAPSHOT_VEHICLE_POS
+                ? 3 : 1;
+        }
+    }
+    return count;
+}
+
+void entity_snapshot::allocate() {
+    /* buffers are allocated at their maximum size once so that the address of
+     * the snapshot can be shared with the game mode */
+    if (!cur_) {
+        cur_ = new cell[SNAPSHOT_MAX_CELLS];
+        memset(cur_, 0, SNAPSHOT_MAX_CELLS * sizeof(cell));
+    }
+}
+
+void entity_snapshot::set_attributes(uint32_t attributes) {
+    attributes_ = attributes & (SNAPSHOT_PLAYER_MASK | SNAPSHOT_VEHICLE_MASK);
+    cells_ = 0;
+    reset();
+
+    if (cur_) {
+        memset(cur_, 0, SNAPSHOT_HEADER_CELLS * sizeof(cell));
+    }
+
+    if (attributes_ != attributes) {
+        log_warning("Ignoring unknown snapshot attributes %08x.",
+            attributes & ~attributes_);
+    }
+
+    if (attributes_) {
+        allocate();
+        update();
+    }
+}
+
+void entity_snapshot::update() {
+    if (!attributes_) {
+        return;
+    }
+
+    int32_t players = GetPlayerPoolSize() + 1;
+    int32_t vehicles = GetVehiclePoolSize() + 1;
+
+    if (players > SNAPSHOT_MAX_PLAYERS) {
+        players = SNAPSHOT_MAX_PLAYERS;
+    }
+    if (vehicles > SNAPSHOT_MAX_VEHICLES) {
+        vehicles = SNAPSHOT_MAX_VEHICLES;
+    }
+
+    cell *ptr = cur_;
+    *ptr++ = (cell)attributes_;
+    *ptr++ = players;
+    *ptr++ = vehicles;
+
+    /* players */
+    cell *connected = ptr;
+    ptr += players;
+    for (int32_t i = 0; i < players; i++) {
+        connected[i] = IsPlayerConnected(i) ? 1 : 0;
+    }
+
+    if (attributes_ & SNAPSHOT_PLAYER_POS) {
+        float *x = (float *)ptr, *y = x + players, *z = y + players;
+        for (int32_t i = 0; i < players; i++) {
+            x[i] = y[i] = z[i] = 0;
+            if (connected[i]) {
+                GetPlayerPos(i, &x[i], &y[i], &z[i]);
+            }
+        }
+        ptr += players * 3;
+    }
+    if (attributes_ & SNAPSHOT_PLAYER_HEALTH) {
+        float *health = (float *)ptr;
+        for (int32_t i = 0; i < players; i++) {
+            health[i] = 0;
+            if (connected[i]) {
+                GetPlayerHealth(i, &health[i]);
+            }
+        }
+        ptr += players;
+    }
+    if (attributes_ & SNAPSHOT_PLAYER_ARMOUR) {
+        float *armour = (float *)ptr;
+        for (int32_t i = 0; i < players; i++) {
+            armour[i] = 0;
+            if (connected[i]) {
+                GetPlayerArmour(i, &armour[i]);
+            }
+        }
+        ptr += players;
+    }
+    if (attributes_ & SNAPSHOT_PLAYER_STATE) {
+        for (int32_t i = 0; i < players; i++) {
+            ptr[i] = connected[i] ? GetPlayerState(i) : 0;
+        }
+        ptr += players;
+    }
+    if (attributes_ & SNAPSHOT_PLAYER_VEHICLE) {
+        for (int32_t i = 0; i < players; i++) {
+            ptr[i] = connected[i] ? GetPlayerVehicleID(i) : 0;
+        }
+        ptr += players;
+    }
+    if (attributes_ & SNAPSHOT_PLAYER_FACING) {
+        float *angle = (float *)ptr;
+        for (int32_t i = 0; i < players; i++) {
+            angle[i] = 0;
+            if (connected[i]) {
+                GetPlayerFacingAngle(i, &angle[i]);
+            }
+        }
+        ptr += players;
+    }
+
+    /* vehicles */
+    cell *exists = ptr;
+    ptr += vehicles;
+    for (int32_t i = 0; i < vehicles; i++) {
+        exists[i] = GetVehicleModel(i) ? 1 : 0;
+    }
+
+    if (attributes_ & SNAPSHOT_VEHICLE_POS) {
+        float *x = (float *)ptr, *y = x + vehicles, *z = y + vehicles;
+        for (int32_t i = 0; i < vehicles; i++) {
+            x[i] = y[i] = z[i] = 0;
+            if (exists[i]) {
+                GetVehiclePos(i, &x[i], &y[i], &z[i]);
+            }
+        }
+        ptr += vehicles * 3;
+    }
+    if (attributes_ & SNAPSHOT_VEHICLE_HEALTH) {
+        float *health = (float *)ptr;
+        for (int32_t i = 0; i < vehicles; i++) {
+            health[i] = 0;
+            if (exists[i]) {
+                GetVehicleHealth(i, &health[i]);
+            }
+        }
+        ptr += vehicles;
+    }
+    if (attributes_ & SNAPSHOT_VEHICLE_ANGLE) {
+        float *angle = (float *)ptr;
+        for (int32_t i = 0; i < vehicles; i++) {
+            angle[i] = 0;
+            if (exists[i]) {
+                GetVehicleZAngle(i, &angle[i]);
+            }
+        }
+        ptr += vehicles;
+    }
+
+    cells_ = (uint32_t)(ptr - cur_);
+}
+
+const cell *entity_snapshot::data() {
+    allocate();
+    return cur_;
+}
+
+const uint8_t *entity_snapshot::encode(uint32_t *len) {
+    if (!cells_) {
+        return NULL;
+    }
+
+    if (!frame_) {
+        prev_ = new cell[SNAPSHOT_MAX_CELLS];
+        frame_ = new uint8_t[SNAPSHOT_MAX_FRAME];
+    }
+
+    uint8_t *ptr = frame_ + SNAPSHOT_FRAME_HEADER;
+    uint8_t *end = frame_ + SNAPSHOT_FRAME_HEADER + cells_ * sizeof(cell);
+    bool keyframe = prev_cells_ != cells_;
+
+    if (!keyframe) {
+        /* the layout is unchanged, collect runs of changed cells. a delta
+         * which is as large as the snapshot is sent as keyframe */
+        uint32_t i = 0;
+        while (i < cells_ && !keyframe) {
+            if (cur_[i] == prev_[i]) {
+                i++;
+                continue;
+            }
+
+            /* extend the run over small gaps of unchanged cells */
+            uint32_t start = i, last = i;
+            for (i++; i < cells_ && i - last <= SNAPSHOT_RUN_GAP; i++) {
+                if (cur_[i] != prev_[i]) {
+                    last = i;
+                }
+            }
+
+            uint32_t count = last - start + 1;
+            i = last + 1;
+
+            if (ptr + SNAPSHOT_RUN_HEADER + count * sizeof(cell) >= end) {
+                keyframe = true;
+                break;
+            }
+
+            *(uint32_t *)ptr = start;
+            ptr += sizeof(uint32_t);
+            *(uint32_t *)ptr = count;
+            ptr += sizeof(uint32_t);
+            memcpy(ptr, cur_ + start, count * sizeof(cell));
+            ptr += count * sizeof(cell);
+        }
+
+        if (!keyframe && ptr == frame_ + SNAPSHOT_FRAME_HEADER) {
+            return NULL;
+        }
+    }
+
+    if (keyframe) {
+        memcpy(frame_ + SNAPSHOT_FRAME_HEADER, cur_, cells_ * sizeof(cell));
+        ptr = end;
+    }
+
+    frame_[0] = keyframe ? 1 : 0;
+    *(uint32_t *)(frame_ + 1) = cells_;
+
+    memcpy(prev_, cur_, cells_ * sizeof(cell));
+    prev_cells_ = cells_;
+
+    *len = (uint32_t)(ptr - frame_);
+    return frame_;
+}
+
+void entity_snapshot::reset() {
+    prev_cells_ = 0;
+}
@@ -0,0 +1,95 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <inttypes.h>
+#include <sampgdk/sampgdk.h>
+
+/* attributes which can be gathered in a snapshot. each attribute is stored as
+ * one array of cells per component, indexed by entity id. the order of the
+ * arrays follows the order of the bits.
+ */
+#define SNAPSHOT_NONE               (0)
+#define SNAPSHOT_PLAYER_POS         (1 << 0)  /* x, y, z */
+#define SNAPSHOT_PLAYER_HEALTH      (1 << 1)
+#define SNAPSHOT_PLAYER_ARMOUR      (1 << 2)
+#define SNAPSHOT_PLAYER_STATE       (1 << 3)
+#define SNAPSHOT_PLAYER_VEHICLE     (1 << 4)
+#define SNAPSHOT_PLAYER_FACING      (1 << 5)
+#define SNAPSHOT_VEHICLE_POS        (1 << 16) /* x, y, z */
+#define SNAPSHOT_VEHICLE_HEALTH     (1 << 17)
+#define SNAPSHOT_VEHICLE_ANGLE      (1 << 18)
+#define SNAPSHOT_PLAYER_MASK        (0x0000003f)
+#define SNAPSHOT_VEHICLE_MASK       (0x00070000)
+
+/* snapshot layout: [attributes][players][vehicles], the player connected
+ * flags, the player attribute arrays, the vehicle exists flags and the
+ * vehicle attribute arrays. all values are cells.
+ */
+#define SNAPSHOT_HEADER_CELLS       (3)
+#define SNAPSHOT_MAX_PLAYERS        (1000)
+#define SNAPSHOT_MAX_VEHICLES       (2000)
+#define SNAPSHOT_PLAYER_CELLS       (9)  /* cells per player with all attributes */
+#define SNAPSHOT_VEHICLE_CELLS      (6)  /* cells per vehicle with all attributes */
+#define SNAPSHOT_MAX_CELLS          (SNAPSHOT_HEADER_CELLS + \
+    SNAPSHOT_MAX_PLAYERS * SNAPSHOT_PLAYER_CELLS + \
+    SNAPSHOT_MAX_VEHICLES * SNAPSHOT_VEHICLE_CELLS)
+
+/* delta frame: [u8 keyframe][u32 cells] followed by either all cells or runs
+ * of [u32 offset][u32 count][count cells] which changed since the previous
+ * frame.
+ */
+#define SNAPSHOT_FRAME_HEADER       (sizeof(uint8_t) + sizeof(uint32_t))
+#define SNAPSHOT_RUN_HEADER         (sizeof(uint32_t) * 2)
+#define SNAPSHOT_RUN_GAP            (2) /* unchanged cells merged into a run */
+#define SNAPSHOT_MAX_FRAME          (SNAPSHOT_FRAME_HEADER + \
+    SNAPSHOT_MAX_CELLS * sizeof(cell))
+
+/** a per-tick snapshot of player and vehicle attributes */
+class entity_snapshot
+{
+public:
+    entity_snapshot();
+    ~entity_snapshot();
+    /** sets the attributes to gather; the next frame is a keyframe */
+    void set_attributes(uint32_t attributes);
+    uint32_t attributes() const { return attributes_; }
+    /** gathers the attributes of all entities */
+    void update();
+    /** the current snapshot; its address does not change once allocated */
+    const cell *data();
+    /** encodes the changes since the previous frame; NULL if unchanged */
+    const uint8_t *encode(uint32_t *len);
+    /** forces the next frame to be a keyframe */
+    void reset();
+private:
+    entity_snapshot(const entity_snapshot &);
+    entity_snapshot &operator=(const entity_snapshot &);
+    static uint32_t count_cells(uint32_t attributes);
+    void allocate();
+    uint32_t attributes_;
+    /** the current snapshot */
+    cell *cur_;
+    /** number of cells in the current snapshot */
+    uint32_t cells_;
+    /** the snapshot of the previous frame */
+    cell *prev_;
+    /** number of cells in the previous frame; 0 forces a keyframe */
+    uint32_t prev_cells_;
+    /** buffer of the encoded frame */
+    uint8_t *frame_;
+};
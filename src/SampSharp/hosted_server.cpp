@@ -15,49 +15,448 @@
 
 #include "hosted_server.h"
 #include "logging.h"
+#include "simd.h"
+#include <string.h>
+#include <stdlib.h>
+#include <sstream>
+#include <chrono>
 
 #define INTEROP_LIB "SampSharp.Core"
 #define INTEROP_CLASS INTEROP_LIB ".Hosting.Interop"
 
+#define REQUEST_INVOKE      (0)
+#define REQUEST_BATCH       (1)
+#define REQUEST_VALUES      (2)
+#define REQUEST_QUEUED      (3) /* batch without a waiting thread */
+#define REQUEST_CALL        (4) /* function which must run on the main thread */
+
+/* return value of callbacks which run on the CLR thread */
+#define ASYNC_DEFAULT_RETVAL (1)
+
+/** a native call made off the main thread */
+struct native_request : mpsc_node {
+    uint8_t type;
+    uint8_t *inbuf;
+    uint32_t inlen;
+    uint8_t *outbuf;
+    uint32_t *outlen;
+    const cell *args;
+    uint32_t count;
+    cell result;
+    /** the natives of a queued batch */
+    std::vector<uint8_t> data;
+    /** the function to run */
+    std::function<void()> call;
+    bool done;
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+/** a call queued for the CLR thread */
+struct async_call : mpsc_node {
+    /** indicates whether the call is a tick */
+    bool tick;
+    /** the name of the callback */
+    std::string name;
+    std::vector<uint8_t> buf;
+};
+
 hosted_server *hosting = NULL;
 
-hosted_server::hosted_server(const char *clr_dir, const char* exe_path) {
+hosted_server::hosted_server(plugin *plg, const char *clr_dir,
+    const char* exe_path) :
+    main_thread_(std::this_thread::get_id()),
+    stopping_(false),
+    producers_(0),
+    async_queued_(0),
+    async_done_(0),
+    async_tick_(false),
+    async_stop_(false),
+    async_running_(false) {
+    std::string native_cache;
+
+    app_.timer().start();
+
+    plg->config("native_cache", native_cache);
+    natives_.load_cache_config(native_cache);
+
+    grid_.set_cell_size(plg->config()->GetOptionDefault("spatial_cell_size",
+        GRID_DEFAULT_CELL_SIZE));
+
+    std::string callback_rate;
+    plg->config("callback_rate", callback_rate);
+    limiter_.load_config(callback_rate);
+
+    std::string clr_thread_callbacks;
+    plg->config("clr_thread_callbacks", clr_thread_callbacks);
+    load_async_config(clr_thread_callbacks);
+
+    boot_timeout_ = plg->config()->GetOptionDefault("coreclr_timeout",
+        (uint32_t)DEFAULT_BOOT_TIMEOUT);
+
+    warmup_calls_ = plg->config()->GetOptionDefault("warmup_calls", 0u);
+
+    /* the runtime is resolved by hostfxr instead of loaded from the coreclr
+     * directory */
+    std::string hostfxr;
+    plg->config("hostfxr", hostfxr);
+    if(!hostfxr.empty()) {
+        app_.set_hostfxr(hostfxr.c_str());
+    }
+
+    /* the game mode is a NativeAOT compiled library */
+    std::string nativeaot;
+    plg->config("nativeaot", nativeaot);
+    app_.set_aot(nativeaot == "1" || nativeaot == "true");
+
+    /* runtime properties; clr_property lines override the profile */
+    std::string profile;
+    plg->config("clr_profile", profile);
+    if(!profile.empty() && !app_.set_profile(profile.c_str())) {
+        log_warning("Unknown CLR profile %s.", profile.c_str());
+    }
+
+    std::vector<std::string> properties;
+    plg->config()->GetOptionValues("clr_property", properties);
+    for(size_t i = 0; i < properties.size(); i++) {
+        const std::string &property = properties[i];
+        size_t split = property.find(' ');
+        size_t value = split == std::string::npos
+            ? split
+            : property.find_first_not_of(' ', split);
+
+        if(value == std::string::npos) {
+            log_warning("Invalid clr_property %s.", property.c_str());
+            continue;
+        }
+
+        app_.set_property(property.substr(0, split), property.substr(value));
+    }
+
+    hosting = this;
+    init_api();
+
+    /* the runtime is initialized while the server boots; the game mode is
+     * started on the main thread once the first callback arrives */
+    boot_thread_ = std::thread(&hosted_server::boot, this,
+        std::string(clr_dir), std::string(exe_path));
+}
+
+void hosted_server::boot(std::string clr_dir, std::string exe_path) {
     int retval;
-    unsigned int exitcode;
-    if((retval = app_.initialize(clr_dir, exe_path, "SampSharp Host")) < 0) {
+    bool ok = false;
+
+    if((retval = app_.initialize(clr_dir.c_str(), exe_path.c_str(),
+        "SampSharp Host")) < 0) {
         log_error("Failed to initialize CoreCLR runtime. Error %d.", retval);
-        return;
     }
+    else {
+        if((retval = app_.create_delegate(INTEROP_LIB, INTEROP_CLASS, "Tick",
+            (void **)&tick_)) < 0) {
+            log_warning("Failed to load Tick delegate. Error %d.", retval);
+        }
+        app_.timer().mark("Tick");
+        if((retval = app_.create_delegate(INTEROP_LIB, INTEROP_CLASS,
+            "PublicCall", (void **)&public_call_)) < 0) {
+            log_warning("Failed to load PublicCall delegate. Error %d.",
+                retval);
+        }
+        app_.timer().mark("PublicCall");
+        if((retval = app_.create_delegate(INTEROP_LIB, INTEROP_CLASS,
+            "DirectCall", (void **)&direct_call_)) < 0) {
+            /* older game mode libraries only accept serialized calls */
+            log_debug("Failed to load DirectCall delegate. Error %d.",
+                retval);
+            direct_call_ = NULL;
+        }
+        app_.timer().mark("DirectCall");
+        if((retval = app_.create_delegate(INTEROP_LIB, INTEROP_CLASS,
+            "Restart", (void **)&restart_)) < 0) {
+            log_debug("Failed to load Restart delegate. Error %d.", retval);
+            restart_ = NULL;
+        }
+        app_.timer().mark("Restart");
+        if(warmup_calls_ && (retval = app_.create_delegate(INTEROP_LIB,
+            INTEROP_CLASS, "DryRunCall", (void **)&dry_run_call_)) < 0) {
+            log_debug("Failed to load DryRunCall delegate. Error %d.",
+                retval);
+            dry_run_call_ = NULL;
+        }
+        app_.timer().mark("DryRunCall");
+        ok = true;
+    }
+
+    std::lock_guard<std::mutex> lock(boot_mutex_);
+    boot_ok_ = ok;
+    booted_ = true;
+    boot_cv_.notify_all();
+}
+
+bool hosted_server::start(bool wait) {
+    int retval;
+    unsigned int exitcode;
 
-    if((retval = app_.create_delegate(INTEROP_LIB, INTEROP_CLASS, "Tick",
-        (void **)&tick_)) < 0) {
-        log_warning("Failed to load Tick delegate. Error %d.", retval);
+    if(running_ || failed_) {
+        return running_;
     }
-    if((retval = app_.create_delegate(INTEROP_LIB, INTEROP_CLASS, "PublicCall",
-        (void **)&public_call_)) < 0) {
-        log_warning("Failed to load PublicCall delegate. Error %d.", retval);
+
+    {
+        std::unique_lock<std::mutex> lock(boot_mutex_);
+
+        /* only the first callback waits; later calls are dropped until the
+         * runtime is ready */
+        uint32_t timeout = wait && !boot_timed_out_ ? boot_timeout_ : 0;
+        if(!boot_cv_.wait_for(lock, std::chrono::milliseconds(timeout),
+            [this] { return booted_; })) {
+            if(wait && !boot_timed_out_) {
+                log_error("CoreCLR runtime is not ready after %u ms.",
+                    timeout);
+                boot_timed_out_ = true;
+            }
+            return false;
+        }
     }
 
-    hosting = this;
-    const char *args[1];
+    boot_thread_.join();
+
+    if(!boot_ok_) {
+        failed_ = true;
+        return false;
+    }
+
+    if(boot_timed_out_) {
+        log_info("CoreCLR runtime is ready.");
+    }
+
+    /* hand the function table to the game mode */
+    char api_address[32];
+    sampsharp_sprintf(api_address, sizeof(api_address), "%llu",
+        (unsigned long long)(uintptr_t)&api_);
+
+    const char *args[3];
     args[0] = "--hosted";
+    args[1] = "--api";
+    args[2] = api_address;
 
     if((retval = app_.execute_assembly(sizeof(args) / sizeof(args[0]), args,
         &exitcode)) < 0)  {
         log_error("Failed to prepare game mode. Error %d.", retval);
-        return;
+        failed_ = true;
+        return false;
     }
 
+    app_.timer().mark("execute");
+
     if(exitcode) {
         log_error("Failed to prepare game mode. Exit code %d.", exitcode);
-        return;
+        failed_ = true;
+        return false;
     }
 
     log_info("Game mode host running.");
+    log_info("Startup: %s.", app_.timer().summary().c_str());
     running_ = true;
+
+    if(!async_callbacks_.empty()) {
+        log_info("Running %u callbacks on the CLR thread.",
+            (uint32_t)async_callbacks_.size());
+        async_ = true;
+        async_running_ = true;
+        async_thread_ = std::thread(&hosted_server::run_async, this);
+    }
+    return true;
+}
+
+void hosted_server::load_async_config(const std::string &value) {
+    /* format: name[=<return value>] separated by spaces */
+    std::istringstream stream(value);
+    std::string entry;
+
+    while (stream >> entry) {
+        size_t sep = entry.find('=');
+
+        async_callbacks_[entry.substr(0, sep)] = sep == std::string::npos
+            ? ASYNC_DEFAULT_RETVAL
+            : atoi(entry.c_str() + sep + 1);
+    }
+}
+
+void hosted_server::queue_async(const char *name, const uint8_t *buf,
+    uint32_t len) {
+    async_call *call = new async_call();
+    call->tick = false;
+    call->name = name;
+    call->buf.assign(buf, buf + len);
+
+    push_async(call);
+}
+
+void hosted_server::queue_async_tick() {
+    async_call *call = new async_call();
+    call->tick = true;
+
+    push_async(call);
+}
+
+void hosted_server::push_async(async_call *call) {
+    async_calls_.push(call);
+    async_queued_++;
+
+    /* the CLR thread checks the number of queued calls under the lock */
+    {
+        std::lock_guard<std::mutex> lock(async_mutex_);
+    }
+    async_wake_.notify_one();
+}
+
+void hosted_server::wait_async() {
+    if (!async_ || async_done_ == async_queued_) {
+        return;
+    }
+
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+    /* the CLR thread may be waiting for natives to run on this thread */
+    while (async_done_ != async_queued_) {
+        run_requests();
+
+        std::unique_lock<std::mutex> lock(async_mutex_);
+        async_idle_.wait_for(lock, std::chrono::milliseconds(1),
+            [this] { return async_done_ == async_queued_; });
+    }
+
+    double elapsed = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+
+    async_waits_++;
+    async_wait_total_ += elapsed;
+    if (elapsed > async_wait_max_) {
+        async_wait_max_ = elapsed;
+    }
+}
+
+void hosted_server::log_async_stats() {
+    if (!async_waits_) {
+        return;
+    }
+
+    log_info("CLR thread: the main thread waited %u times for queued calls, "
+        "%.1f ms in total, %.1f ms at most.", async_waits_,
+        async_wait_total_, async_wait_max_);
+
+    async_waits_ = 0;
+    async_wait_total_ = async_wait_max_ = 0;
+}
+
+void hosted_server::run_async() {
+    async_call *call;
+
+    /* the game mode treats the thread which runs its ticks as its main
+     * thread; tick once before running callbacks */
+    mutex_.lock();
+    if (tick_) {
+        tick_();
+    }
+    mutex_.unlock();
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(async_mutex_);
+            async_wake_.wait(lock, [this] {
+                return async_stop_ || async_done_ != async_queued_;
+            });
+        }
+
+        if (async_stop_) {
+            break;
+        }
+
+        while ((call = (async_call *)async_calls_.pop())) {
+            mutex_.lock();
+            if (call->tick) {
+                async_tick_ = false;
+                if (tick_) {
+                    tick_();
+                }
+            }
+            else {
+                /* callbacks without parameters have no arguments */
+                public_call_(call->name.c_str(),
+                    call->buf.empty() ? NULL : &call->buf[0],
+                    (uint32_t)call->buf.size());
+            }
+            mutex_.unlock();
+
+            delete call;
+            async_done_++;
+
+            {
+                std::lock_guard<std::mutex> lock(async_mutex_);
+            }
+            async_idle_.notify_all();
+        }
+    }
+
+    /* calls which have not run are dropped */
+    while ((call = (async_call *)async_calls_.pop())) {
+        delete call;
+    }
+
+    async_running_ = false;
+}
+
+void hosted_server::stop_async() {
+    if (!async_thread_.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(async_mutex_);
+        async_stop_ = true;
+    }
+    async_wake_.notify_one();
+
+    /* natives requested by the CLR thread are failed while stopping */
+    while (async_running_) {
+        run_requests();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    async_thread_.join();
+    async_ = false;
+}
+
+void hosted_server::call_on_main_thread(const std::function<void()> &call) {
+    if (is_main_thread()) {
+        call();
+        return;
+    }
+
+    native_request request;
+    request.type = REQUEST_CALL;
+    request.call = call;
+    request.outlen = NULL;
+    wait_request(&request);
 }
 
 hosted_server::~hosted_server() {
+    /* the runtime can not be released while it is being initialized */
+    if(boot_thread_.joinable()) {
+        boot_thread_.join();
+    }
+
+    /* release threads waiting for natives; a thread which has not seen
+     * stopping_ yet may still be queueing its request */
+    stopping_ = true;
+    stop_async();
+    log_async_stats();
+    while (producers_) {
+        run_requests();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    run_requests();
+
     app_.release();
 
     if(hosting == this) {
@@ -66,26 +465,235 @@ hosted_server::~hosted_server() {
 }
 
 void hosted_server::tick() {
-    if(tick_) {
+    /* the game mode is started by the first callback; ticks never run its
+     * startup */
+    if(!running_) {
+        return;
+    }
+
+    natives_.tick();
+    run_requests();
+
+    /* the snapshot is not updated while the CLR thread may read it */
+    if(!async_ || async_done_ == async_queued_) {
+        snapshot_.update();
+    }
+    grid_.tick();
+
+    if(public_call_) {
+        /* deliver the latest calls of ended rate limit windows */
+        callback_limiter::due_call call;
+        while (limiter_.next_due(&call)) {
+            if (async_ && async_callbacks_.count(call.name)) {
+                queue_async(call.name, call.buf, call.len);
+                continue;
+            }
+
+            /* the slot may be reused by calls made during delivery */
+            pooled_buffer buf(&pool_, call.len);
+            if (!buf.get()) {
+                continue;
+            }
+            memcpy(buf.get(), call.buf, call.len);
+
+            wait_async();
+            mutex_.lock();
+            public_call_(call.name, buf.get(), call.len);
+            mutex_.unlock();
+        }
+    }
+
+    if(async_) {
+        /* a tick is only queued once the previous tick has run */
+        if(!async_tick_.exchange(true)) {
+            queue_async_tick();
+        }
+    }
+    else if(tick_) {
         tick_();
     }
+
+    /* free buffers of past spikes */
+    pool_.trim();
 }
 
 void hosted_server::public_call(AMX *amx, const char *name, cell *params,
     cell *retval) {
+    if(!start(true)) {
+        return;
+    }
+
+    forward_call(amx, name, params, retval);
+
+    /* callbacks are registered by the time the game mode has initialized */
+    if(!strcmp(name, "OnGameModeInit")) {
+        warm_up();
+    }
+
+    /* the runtime survives game mode restarts */
+    if(!strcmp(name, "OnGameModeExit")) {
+        restart();
+    }
+}
+
+void hosted_server::warm_up() {
+    /* compiled code survives game mode restarts */
+    if(!warmup_calls_ || !dry_run_call_ || warmed_up_) {
+        return;
+    }
+    warmed_up_ = true;
+
+    std::vector<std::string> names;
+    callbacks_.registered(names);
+
+    startup_timer timer;
+    uint32_t count = 0;
+
+    /* dry runs take the path of direct calls with a synthetic AMX. all
+     * arguments are zero: strings are read from address 0, which holds an
+     * empty string, and arrays have a length of zero */
+    cell data[1] = { 0 };
+    cell params[1 + DRY_RUN_MAX_PARAMS];
+    AMX_HEADER header;
+    AMX amx;
+
+    memset(params, 0, sizeof(params));
+    memset(&header, 0, sizeof(header));
+    memset(&amx, 0, sizeof(amx));
+    amx.base = (unsigned char *)&header;
+    amx.data = (unsigned char *)data;
+    amx.hea = amx.stk = amx.stp = sizeof(data);
+
+    wait_async();
+    mutex_.lock();
+
+    for(size_t i = 0; i < names.size(); i++) {
+        const char *name = names[i].c_str();
+        int32_t id = callbacks_.id(name);
+        uint32_t param_count = callbacks_.param_count(name);
+
+        if(!strcmp(name, "OnGameModeInit") ||
+            !strcmp(name, "OnGameModeExit") ||
+            id < 0 || param_count > DRY_RUN_MAX_PARAMS) {
+            continue;
+        }
+
+        params[0] = (cell)(param_count * sizeof(cell));
+
+        for(uint32_t n = 0; n < warmup_calls_; n++) {
+            dry_run_call_(id, &amx, params);
+        }
+
+        timer.mark(name);
+        count++;
+    }
+
+    mutex_.unlock();
+
+    log_info("Warm-up of %u callbacks: %s.", count, timer.summary().c_str());
+}
+
+void hosted_server::restart() {
+    log_info("Game mode exited; keeping the runtime for the next game "
+        "mode.");
+
+    limiter_.reset();
+    natives_.reset();
+    log_async_stats();
+
+    /* filters and snapshot attributes are set again by the next game mode */
+    callbacks_.clear_filters();
+    snapshot_.set_attributes(SNAPSHOT_NONE);
+
+    if(restart_) {
+        wait_async();
+        mutex_.lock();
+        restart_();
+        mutex_.unlock();
+    }
+}
+
+void hosted_server::forward_call(AMX *amx, const char *name, cell *params,
+    cell *retval) {
+    int32_t id;
     uint32_t 
         response, 
         len;
+    uint8_t *buf = buf_;
+    pooled_buffer large(&pool_);
 
     if(public_call_) {
+        /* natives requested off the main thread do not wait for the tick */
+        run_requests();
+
+        /* calls deferred for a previous player are not delivered */
+        limiter_.release(name, params);
+
+        /* calls rejected by their filter are not forwarded */
+        if (!callbacks_.accepts(amx, name, params, retval)) {
+            return;
+        }
+
+        /* calls without a meaningful return value may run on the CLR
+         * thread; their arguments are copied */
+        std::map<std::string, cell>::const_iterator async = async_
+            ? async_callbacks_.find(name)
+            : async_callbacks_.end();
+        bool is_async = async != async_callbacks_.end();
+        bool is_direct = !is_async && direct_call_ &&
+            (id = callbacks_.id(name)) >= 0;
+
+        /* calls within the rate limit window are deferred; the window of
+         * other calls is checked once their arguments are serialized */
+        bool limited = is_direct && limiter_.limit(name, params);
+
+        /* pass the arguments in place; the game mode reads strings and
+         * arrays from the AMX itself */
+        if (is_direct && !limited) {
+            wait_async();
+            mutex_.lock();
+
+            response = direct_call_(id, amx, params);
+
+            mutex_.unlock();
+
+            if (retval) {
+                *retval = response;
+            }
+            return;
+        }
+
         len = LEN_CBBUF;
-        if(!callbacks_.fill_call_buffer(amx, name, params, buf_, &len, false)) {
+        if(!callbacks_.fill_call_buffer(amx, name, params, buf, &len, false)) {
+            if (len <= LEN_CBBUF || !(buf = large.acquire(len))) {
+                return;
+            }
+
+            /* the call does not fit the callback buffer */
+            len = large.capacity();
+            if(!callbacks_.fill_call_buffer(amx, name, params, buf, &len,
+                false)) {
+                return;
+            }
+        }
+
+        if (limited || (!is_direct && limiter_.limit(name, params))) {
+            limiter_.defer(buf, len, retval);
             return;
         }
 
+        if (is_async) {
+            queue_async(name, buf, len);
+            if (retval) {
+                *retval = async->second;
+            }
+            return;
+        }
+
+        wait_async();
         mutex_.lock();
 
-        response = public_call_(name, buf_, len);
+        response = public_call_(name, buf, len);
 
         mutex_.unlock();
 
@@ -100,19 +708,344 @@ void hosted_server::print(const char* msg) const {
 }
 
 int hosted_server::get_native_handle(const char* name) {
-    return natives_.get_handle(name);
+    int handle = NATIVE_NOT_FOUND;
+    call_on_main_thread([&] { handle = natives_.get_handle(name); });
+    return handle;
+}
+
+bool hosted_server::is_main_thread() const {
+    return std::this_thread::get_id() == main_thread_;
+}
+
+void hosted_server::wait_request(native_request *request) {
+    request->done = false;
+
+    /* counted before stopping_ is checked so the destructor either sees the
+     * request or the request sees stopping_ */
+    producers_++;
+
+    if (stopping_) {
+        producers_--;
+        complete_request(request);
+        return;
+    }
+
+    requests_.push(request);
+
+    {
+        std::unique_lock<std::mutex> lock(request->mutex);
+        request->cv.wait(lock, [request] { return request->done; });
+    }
+
+    producers_--;
+}
+
+void hosted_server::run_requests() {
+    native_request *request;
+
+    while ((request = (native_request *)requests_.pop())) {
+        if (stopping_) {
+            /* fail requests once the server is shutting down */
+            if (request->type == REQUEST_QUEUED) {
+                delete request;
+            }
+            else {
+                if (request->outlen) {
+                    *request->outlen = 0;
+                }
+                request->result = 0;
+                complete_request(request);
+            }
+            continue;
+        }
+
+        switch (request->type) {
+        case REQUEST_INVOKE:
+            invoke_native(request->inbuf, request->inlen, request->outbuf,
+                request->outlen);
+            break;
+        case REQUEST_BATCH:
+            invoke_batch(request->inbuf, request->inlen, request->outbuf,
+                request->outlen);
+            break;
+        case REQUEST_VALUES:
+            request->result = invoke_values(request->args[0],
+                request->args + 1, request->count);
+            break;
+        case REQUEST_CALL:
+            request->call();
+            break;
+        case REQUEST_QUEUED: {
+            pooled_buffer response(&pool_, POOL_MIN_SIZE);
+            uint32_t pos = 0, len;
+
+            /* results are discarded; invoke in parts if responses do not
+             * fit and grow the buffer if not even one response fits */
+            while (pos < request->data.size() && response.get()) {
+                len = response.capacity();
+                natives_.invoke_batch(&request->data[pos],
+                    (uint32_t)request->data.size() - pos, response.get(),
+                    &len);
+
+                uint32_t count = 0;
+                if (len >= sizeof(uint32_t)) {
+                    memcpy(&count, response.get(), sizeof(uint32_t));
+                }
+                if (count == 0) {
+                    if (response.capacity() >= POOL_MAX_SIZE) {
+                        log_error("Failed to invoke queued natives.");
+                        break;
+                    }
+
+                    response.acquire(response.capacity() * 2);
+                    continue;
+                }
+
+                /* skip the invoked natives */
+                for (uint32_t i = 0; i < count; i++) {
+                    uint32_t call_len;
+                    memcpy(&call_len, &request->data[pos], sizeof(uint32_t));
+                    pos += sizeof(uint32_t) + call_len;
+                }
+            }
+
+            delete request;
+            continue;
+        }
+        }
+
+        complete_request(request);
+    }
+}
+
+void hosted_server::complete_request(native_request *request) {
+    /* the waiting thread owns the request; do not touch it after notifying */
+    std::lock_guard<std::mutex> lock(request->mutex);
+    request->done = true;
+    request->cv.notify_one();
 }
 
 void hosted_server::invoke_native(uint8_t *inbuf, uint32_t inlen,
     uint8_t *outbuf, uint32_t *outlen) {
-    natives_.invoke(inbuf, inlen, outbuf, outlen);
+    if (!is_main_thread()) {
+        native_request request;
+        request.type = REQUEST_INVOKE;
+        request.inbuf = inbuf;
+        request.inlen = inlen;
+        request.outbuf = outbuf;
+        request.outlen = outlen;
+        wait_request(&request);
+        return;
+    }
+
+    uint32_t capacity = *outlen;
+
+    if (!natives_.invoke(inbuf, inlen, outbuf, outlen) && *outlen > capacity) {
+        log_error("Native output buffer is full.");
+        *outlen = 0;
+    }
+}
+
+void hosted_server::invoke_batch(uint8_t *inbuf, uint32_t inlen,
+    uint8_t *outbuf, uint32_t *outlen) {
+    if (!is_main_thread()) {
+        native_request request;
+        request.type = REQUEST_BATCH;
+        request.inbuf = inbuf;
+        request.inlen = inlen;
+        request.outbuf = outbuf;
+        request.outlen = outlen;
+        wait_request(&request);
+        return;
+    }
+
+    natives_.invoke_batch(inbuf, inlen, outbuf, outlen);
+}
+
+int32_t hosted_server::invoke_values(int32_t handle, const cell *args,
+    uint32_t count) {
+    cell result = 0;
+
+    if (!is_main_thread()) {
+        /* the handle is passed in front of the arguments */
+        std::vector<cell> values(count + 1);
+        values[0] = handle;
+        memcpy(&values[1], args, count * sizeof(cell));
+
+        native_request request;
+        request.type = REQUEST_VALUES;
+        request.args = &values[0];
+        request.count = count;
+        request.outlen = NULL;
+        wait_request(&request);
+        return request.result;
+    }
+
+    natives_.invoke_values(handle, args, count, &result);
+    return result;
+}
+
+void hosted_server::queue_batch(uint8_t *inbuf, uint32_t inlen) {
+    producers_++;
+
+    if (stopping_) {
+        producers_--;
+        return;
+    }
+
+    /* the natives are invoked during the next tick, also when queued from
+     * the main thread */
+    native_request *request = new native_request();
+    request->type = REQUEST_QUEUED;
+    request->data.assign(inbuf, inbuf + inlen);
+    requests_.push(request);
+
+    producers_--;
 }
 
-void hosted_server::register_callback(uint8_t* buf) {
+/* the maps are only changed on the main thread, which reads them without
+ * locking; calls made on the CLR thread wait for the main thread */
+
+int32_t hosted_server::register_callback(uint8_t* buf) {
+    int32_t id = -1;
     log_debug("Register callback %s", buf);
-    callbacks_.register_buffer(buf);
+    call_on_main_thread([&] { id = callbacks_.register_buffer(buf); });
+    return id;
+}
+
+void hosted_server::register_filter(uint8_t *buf, uint32_t len) {
+    log_debug("Register filter %s", buf);
+    call_on_main_thread([&] { callbacks_.register_filter(buf, len); });
+}
+
+void hosted_server::set_native_cache(int32_t handle,
+    native_cache_policy policy, uint32_t ttl) {
+    call_on_main_thread([&] { natives_.set_cache(handle, policy, ttl); });
+}
+
+const cell *hosted_server::set_snapshot(uint32_t attributes) {
+    call_on_main_thread([&] { snapshot_.set_attributes(attributes); });
+    return snapshot_.data();
+}
+
+uint32_t hosted_server::query_radius(uint32_t kinds, float x, float y,
+    float z, float radius, int32_t *ids, uint32_t capacity) {
+    uint32_t count = 0;
+    call_on_main_thread([&] {
+        count = grid_.query(kinds, x, y, z, radius, ids, capacity);
+    });
+    return count;
+}
+
+uint32_t hosted_server::get_string(AMX *amx, cell address, char *buf,
+    uint32_t capacity) {
+    cell *addr = NULL;
+    int len = 0;
+    uint32_t narrow_len;
+
+    amx_GetAddr(amx, address, &addr);
+
+    if (addr == NULL) {
+        if (capacity) {
+            buf[0] = 0;
+        }
+        return 0;
+    }
+
+    if (!simd_is_packed(addr)) {
+        narrow_len = simd_narrow_cells(addr, buf, capacity);
+        return narrow_len != SIMD_NOT_TERMINATED
+            ? narrow_len
+            : simd_cells_strlen(addr);
+    }
+
+    amx_StrLen(addr, &len);
+    if ((uint32_t)len < capacity) {
+        amx_GetString(buf, addr, 0, capacity);
+    }
+    return (uint32_t)len;
+}
+
+#pragma region Function table
+
+/* the table is only handed out while hosting is set */
+
+static void CORECLR_CALL api_print(const char *msg) {
+    hosting->print(msg);
+}
+
+static int32_t CORECLR_CALL api_get_native_handle(const char *name) {
+    return hosting->get_native_handle(name);
+}
+
+static void CORECLR_CALL api_invoke_native(uint8_t *inbuf, uint32_t inlen,
+    uint8_t *outbuf, uint32_t *outlen) {
+    hosting->invoke_native(inbuf, inlen, outbuf, outlen);
+}
+
+static void CORECLR_CALL api_invoke_batch(uint8_t *inbuf, uint32_t inlen,
+    uint8_t *outbuf, uint32_t *outlen) {
+    hosting->invoke_batch(inbuf, inlen, outbuf, outlen);
+}
+
+static int32_t CORECLR_CALL api_invoke_values(int32_t handle,
+    const cell *args, uint32_t count) {
+    return hosting->invoke_values(handle, args, count);
+}
+
+static int32_t CORECLR_CALL api_invoke_int_float3(int32_t handle, int32_t a,
+    float x, float y, float z) {
+    cell args[4] = { a, amx_ftoc(x), amx_ftoc(y), amx_ftoc(z) };
+    return hosting->invoke_values(handle, args, 4);
+}
+
+static int32_t CORECLR_CALL api_register_callback(uint8_t *buf) {
+    return hosting->register_callback(buf);
+}
+
+static void CORECLR_CALL api_register_filter(uint8_t *buf, uint32_t len) {
+    hosting->register_filter(buf, len);
+}
+
+static void CORECLR_CALL api_set_native_cache(int32_t handle,
+    int32_t policy, uint32_t ttl) {
+    hosting->set_native_cache(handle, (native_cache_policy)policy, ttl);
+}
+
+static void CORECLR_CALL api_get_amx_address(AMX *amx, cell address,
+    cell **ptr) {
+    *ptr = NULL;
+    amx_GetAddr(amx, address, ptr);
+}
+
+static uint32_t CORECLR_CALL api_get_amx_string(AMX *amx, cell address,
+    char *buf, uint32_t capacity) {
+    return hosted_server::get_string(amx, address, buf, capacity);
+}
+
+static void CORECLR_CALL api_queue_batch(uint8_t *inbuf, uint32_t inlen) {
+    hosting->queue_batch(inbuf, inlen);
+}
+
+void hosted_server::init_api() {
+    api_.version = HOSTED_API_VERSION;
+    api_.size = sizeof(hosted_api);
+    api_.print = api_print;
+    api_.get_native_handle = api_get_native_handle;
+    api_.invoke_native = api_invoke_native;
+    api_.invoke_batch = api_invoke_batch;
+    api_.invoke_values = api_invoke_values;
+    api_.invoke_int_float3 = api_invoke_int_float3;
+    api_.register_callback = api_register_callback;
+    api_.register_filter = api_register_filter;
+    api_.set_native_cache = api_set_native_cache;
+    api_.get_amx_address = api_get_amx_address;
+    api_.get_amx_string = api_get_amx_string;
+    api_.queue_batch = api_queue_batch;
 }
 
+#pragma endregion
+
 SAMPSHARP_EXPORT void SAMPSHARP_CALL sampsharp_print(const char *msg) {
     if(hosting) {
         hosting->print(msg);
@@ -140,3 +1073,46 @@ SAMPSHARP_EXPORT void SAMPSHARP_CALL sampsharp_register_callback(uint8_t *buf) {
         hosting->register_callback(buf);
     }
 }
+
+SAMPSHARP_EXPORT void SAMPSHARP_CALL sampsharp_register_callback_id(
+    uint8_t *buf, int *id) {
+    *id = hosting ? hosting->register_callback(buf) : -1;
+}
+
+SAMPSHARP_EXPORT void SAMPSHARP_CALL sampsharp_register_filter(uint8_t *buf,
+    unsigned int len) {
+    if(hosting) {
+        hosting->register_filter(buf, len);
+    }
+}
+
+SAMPSHARP_EXPORT void SAMPSHARP_CALL sampsharp_set_native_cache(int handle,
+    int policy, unsigned int ttl) {
+    if(hosting) {
+        hosting->set_native_cache(handle, (native_cache_policy)policy, ttl);
+    }
+}
+
+SAMPSHARP_EXPORT void SAMPSHARP_CALL sampsharp_set_snapshot(
+    unsigned int attributes, const cell **data) {
+    *data = hosting ? hosting->set_snapshot(attributes) : NULL;
+}
+
+SAMPSHARP_EXPORT void SAMPSHARP_CALL sampsharp_query_radius(
+    unsigned int kinds, float x, float y, float z, float radius, int *ids,
+    unsigned int *count) {
+    *count = hosting
+        ? hosting->query_radius(kinds, x, y, z, radius, ids, *count)
+        : 0;
+}
+
+SAMPSHARP_EXPORT void SAMPSHARP_CALL sampsharp_get_amx_address(AMX *amx,
+    cell address, cell **ptr) {
+    *ptr = NULL;
+    amx_GetAddr(amx, address, ptr);
+}
+
+SAMPSHARP_EXPORT void SAMPSHARP_CALL sampsharp_get_amx_string(AMX *amx,
+    cell address, char *buf, unsigned int *len) {
+    *len = hosted_server::get_string(amx, address, buf, *len);
+}
@@ -20,20 +20,74 @@
 #include "coreclr_app.h"
 #include "natives_map.h"
 #include "callbacks_map.h"
+#include "buffer_pool.h"
+#include "entity_snapshot.h"
+#include "spatial_grid.h"
+#include "callback_limiter.h"
+#include "plugin.h"
+#include "mpsc_queue.h"
+#include <atomic>
 #include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <string>
 #include <inttypes.h>
 
 #define LEN_CBBUF (1024 * 16)
 
+/* maximum number of parameters of a callback called as a dry run */
+#define DRY_RUN_MAX_PARAMS (32)
+
+/* time the first callback waits for the runtime to be initialized */
+#define DEFAULT_BOOT_TIMEOUT (30000)
+
 typedef void (CORECLR_CALL *tick_ptr)();
 
 typedef int32_t (CORECLR_CALL *public_call_ptr)(const char *name, uint8_t *args,
     uint32_t length);
 
+typedef void (CORECLR_CALL *restart_ptr)();
+
+typedef int32_t (CORECLR_CALL *direct_call_ptr)(int32_t id, AMX *amx,
+    cell *params);
+
+#define HOSTED_API_VERSION 2
+
+/** table of functions handed to the game mode at startup. fields are only
+ * appended; the game mode uses the fields which fit the size of the table */
+struct hosted_api {
+    uint32_t version;
+    uint32_t size;
+    void (CORECLR_CALL *print)(const char *msg);
+    int32_t (CORECLR_CALL *get_native_handle)(const char *name);
+    void (CORECLR_CALL *invoke_native)(uint8_t *inbuf, uint32_t inlen,
+        uint8_t *outbuf, uint32_t *outlen);
+    void (CORECLR_CALL *invoke_batch)(uint8_t *inbuf, uint32_t inlen,
+        uint8_t *outbuf, uint32_t *outlen);
+    int32_t (CORECLR_CALL *invoke_values)(int32_t handle, const cell *args,
+        uint32_t count);
+    int32_t (CORECLR_CALL *invoke_int_float3)(int32_t handle, int32_t a,
+        float x, float y, float z);
+    int32_t (CORECLR_CALL *register_callback)(uint8_t *buf);
+    void (CORECLR_CALL *register_filter)(uint8_t *buf, uint32_t len);
+    void (CORECLR_CALL *set_native_cache)(int32_t handle, int32_t policy,
+        uint32_t ttl);
+    void (CORECLR_CALL *get_amx_address)(AMX *amx, cell address, cell **ptr);
+    uint32_t (CORECLR_CALL *get_amx_string)(AMX *amx, cell address,
+        char *buf, uint32_t capacity);
+    /* version 2 */
+    void (CORECLR_CALL *queue_batch)(uint8_t *inbuf, uint32_t inlen);
+};
+
+struct native_request;
+struct async_call;
+
 /** a CLR hosted game mode server */
 class hosted_server : public server {
 public:
-    hosted_server(const char *clr_dir, const char* exe_path);
+    hosted_server(plugin *plg, const char *clr_dir, const char* exe_path);
     ~hosted_server();
     void tick() override;
     void public_call(AMX *amx, const char *name, cell *params, cell *retval) override;
@@ -41,23 +95,153 @@ public:
     int get_native_handle(const char *name);
     void invoke_native(uint8_t *inbuf, uint32_t inlen, uint8_t *outbuf,
         uint32_t *outlen);
-    void register_callback(uint8_t *buf);
+    void invoke_batch(uint8_t *inbuf, uint32_t inlen, uint8_t *outbuf,
+        uint32_t *outlen);
+    int32_t invoke_values(int32_t handle, const cell *args, uint32_t count);
+    /** queues a batch of natives to be invoked during the next tick without
+     * waiting for the results */
+    void queue_batch(uint8_t *inbuf, uint32_t inlen);
+    /** registers a callback; returns the identifier of the callback */
+    int32_t register_callback(uint8_t *buf);
+    void register_filter(uint8_t *buf, uint32_t len);
+    void set_native_cache(int32_t handle, native_cache_policy policy,
+        uint32_t ttl);
+    /** sets the snapshot attributes; returns the address of the snapshot */
+    const cell *set_snapshot(uint32_t attributes);
+    /** finds entities within radius of a point; returns the number found */
+    uint32_t query_radius(uint32_t kinds, float x, float y, float z,
+        float radius, int32_t *ids, uint32_t capacity);
+    /** copies a string from AMX memory; returns the length of the string */
+    static uint32_t get_string(AMX *amx, cell address, char *buf,
+        uint32_t capacity);
 
 private:
+    /** initializes the runtime and loads the delegates; runs on the boot
+     * thread */
+    void boot(std::string clr_dir, std::string exe_path);
+    /** starts the game mode once the runtime is initialized; returns true if
+     * the game mode is running */
+    bool start(bool wait);
+    /** resets the state of the exited game mode; the runtime is kept */
+    void restart();
+    /** calls every registered callback with synthetic arguments as dry runs
+     * so the game mode is compiled before players join */
+    void warm_up();
+    /** forwards a public call to the game mode */
+    void forward_call(AMX *amx, const char *name, cell *params, cell *retval);
+    /** loads the callbacks which run on the CLR thread from a list of
+     * name[=<return value>] entries */
+    void load_async_config(const std::string &value);
+    /** queues a call for the CLR thread */
+    void queue_async(const char *name, const uint8_t *buf, uint32_t len);
+    /** queues a tick for the CLR thread */
+    void queue_async_tick();
+    void push_async(async_call *call);
+    /** waits for the CLR thread to run all queued calls. synchronous
+     * callbacks keep their order after queued calls, so a pause of the CLR
+     * thread still stalls the next synchronous callback on the main thread;
+     * the waits are measured and logged by log_async_stats */
+    void wait_async();
+    void log_async_stats();
+    /** runs queued calls; runs on the CLR thread */
+    void run_async();
+    void stop_async();
+    /** runs a function on the main thread and waits for it to finish */
+    void call_on_main_thread(const std::function<void()> &call);
+    void init_api();
+    bool is_main_thread() const;
+    /** queues a request made off the main thread and waits for the result;
+     * the request is run during the next tick, callback or drain of the
+     * CLR thread, so the calling thread blocks for at most a tick */
+    void wait_request(native_request *request);
+    /** invokes the natives requested off the main thread */
+    void run_requests();
+    void complete_request(native_request *request);
+
     /** the running game mode CLR instance */
     coreclr_app app_;
+    /** functions handed to the game mode */
+    hosted_api api_;
     /** buffer */
     uint8_t buf_[LEN_CBBUF];
+    /** pool of buffers for calls exceeding the callback buffer */
+    buffer_pool pool_;
     /** map of registered callbacks */
     callbacks_map callbacks_;
     /** map of registred native functions */
     natives_map natives_;
+    /** per-tick snapshot of entity state shared with the game mode */
+    entity_snapshot snapshot_;
+    /** index of entity positions for radius queries */
+    spatial_grid grid_;
+    /** rate limits of high-frequency callbacks */
+    callback_limiter limiter_;
+    /** natives requested off the main thread */
+    mpsc_queue requests_;
+    /** the thread which runs the server */
+    std::thread::id main_thread_;
+    /** indicates whether requests are no longer run */
+    std::atomic<bool> stopping_;
+    /** number of threads queueing or waiting for requests */
+    std::atomic<uint32_t> producers_;
     /** lock for callbacks/ticks */
     std::recursive_mutex mutex_;
     /** pointer to the tick CLR function */
     tick_ptr tick_ = NULL;
     /** pointer to the public call CLR function */
     public_call_ptr public_call_ = NULL;
+    /** pointer to the direct call CLR function */
+    direct_call_ptr direct_call_ = NULL;
+    /** pointer to the restart CLR function */
+    restart_ptr restart_ = NULL;
+    /** pointer to the dry run call CLR function */
+    direct_call_ptr dry_run_call_ = NULL;
+    /** number of dry runs of each callback after the game mode has started */
+    uint32_t warmup_calls_ = 0;
+    /** indicates whether the callbacks have been warmed up */
+    bool warmed_up_ = false;
+    /** the thread which initializes the runtime */
+    std::thread boot_thread_;
+    /** lock for the boot state */
+    std::mutex boot_mutex_;
+    /** signaled when the boot thread has finished */
+    std::condition_variable boot_cv_;
+    /** indicates whether the boot thread has finished */
+    bool booted_ = false;
+    /** indicates whether the runtime has been initialized */
+    bool boot_ok_ = false;
+    /** indicates whether waiting for the runtime has timed out */
+    bool boot_timed_out_ = false;
+    /** time in milliseconds the first callback waits for the runtime */
+    uint32_t boot_timeout_ = DEFAULT_BOOT_TIMEOUT;
     /** indicates whether the game mode is running */
     bool running_ = false;
+    /** indicates whether the game mode failed to start */
+    bool failed_ = false;
+    /** callbacks which run on the CLR thread and their return values */
+    std::map<std::string, cell> async_callbacks_;
+    /** indicates whether calls run on the CLR thread */
+    bool async_ = false;
+    /** the thread which runs queued calls */
+    std::thread async_thread_;
+    /** calls queued for the CLR thread */
+    mpsc_queue async_calls_;
+    /** number of calls queued and run */
+    std::atomic<uint32_t> async_queued_;
+    std::atomic<uint32_t> async_done_;
+    /** indicates whether a tick is queued */
+    std::atomic<bool> async_tick_;
+    /** indicates whether the CLR thread should stop */
+    std::atomic<bool> async_stop_;
+    /** indicates whether the CLR thread is running */
+    std::atomic<bool> async_running_;
+    /** lock and signals for waking the CLR thread and waiting for it */
+    std::mutex async_mutex_;
+    std::condition_variable async_wake_;
+    std::condition_variable async_idle_;
+    /** number, total and longest duration in milliseconds of the waits of
+     * the main thread for queued calls */
+    uint32_t async_waits_ = 0;
+    double async_wait_total_ = 0;
+    double async_wait_max_ = 0;
 };
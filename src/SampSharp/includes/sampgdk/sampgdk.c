@@ -1922,11 +1922,18 @@ cell *sampgdk_param_get_start(AMX *amx) {
 /* #include "fakeamx.h" */
 /* #include "init.h" */
 
+/* SampSharp: vectorized conversion of strings pushed and read back. */
+#include "../../simd.h"
+
 /* Space reserved for the stack. */
 #define _SAMPGDK_FAKEAMX_STACK_SIZE 64
 
-/* The initial size of the heap. */
-#define _SAMPGDK_FAKEAMX_HEAP_SIZE 1024
+/* The initial size of the heap.
+ *
+ * SampSharp: large enough for the arguments of any native call that fits
+ * the network buffers so the heap is not grown during calls.
+ */
+#define _SAMPGDK_FAKEAMX_HEAP_SIZE (1024 * 64)
 
 static struct {
   AMX                  amx;
@@ -2083,6 +2090,7 @@ int sampgdk_fakeamx_push_array(const cell *src, int size, cell *address) {
 int sampgdk_fakeamx_push_string(const char *src, int *size, cell *address) {
   int src_size;
   int error;
+  cell *dest;
 
   assert(address != NULL);
   assert(src != NULL);
@@ -2092,9 +2100,10 @@ int sampgdk_fakeamx_push_string(const char *src, int *size, cell *address) {
     return error;
   }
 
-  amx_SetString((cell *)sampgdk_array_get(&_sampgdk_fakeamx.heap,
-                                 *address / sizeof(cell)),
-                src, 0, 0, src_size);
+  dest = (cell *)sampgdk_array_get(&_sampgdk_fakeamx.heap,
+                                   *address / sizeof(cell));
+  simd_widen_chars(src, dest, src_size - 1);
+  dest[src_size - 1] = 0;
 
   if (size != NULL) {
     *size = src_size;
@@ -2143,12 +2152,19 @@ void sampgdk_fakeamx_get_array(cell address, cell *dest, int size) {
 }
 
 void sampgdk_fakeamx_get_string(cell address, char *dest, int size) {
+  cell *src;
+
   assert(address % sizeof(cell) == 0);
   assert(dest != NULL);
 
-  amx_GetString(dest, (cell *)sampgdk_array_get(&_sampgdk_fakeamx.heap,
-                                                address / sizeof(cell)),
-                                                0, size);
+  src = (cell *)sampgdk_array_get(&_sampgdk_fakeamx.heap,
+                                  address / sizeof(cell));
+
+  if (simd_is_packed(src) || size <= 0) {
+    amx_GetString(dest, src, 0, size);
+  } else if (simd_narrow_cells(src, dest, size) == SIMD_NOT_TERMINATED) {
+    dest[size - 1] = '\0';
+  }
 }
 
 void sampgdk_fakeamx_pop(cell address) {
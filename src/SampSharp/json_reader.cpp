@@ -0,0 +1,311 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "json_reader.h"
+#include <string.h>
+
+json_reader::json_reader(const char *data, size_t len) :
+    data_(data),
+    len_(data ? len : 0),
+    pos_(0),
+    failed_(false) {
+}
+
+bool json_reader::fail() {
+    failed_ = true;
+    pos_ = len_;
+    return false;
+}
+
+void json_reader::skip_whitespace() {
+    while (pos_ < len_ && (data_[pos_] == ' ' || data_[pos_] == '\n' ||
+        data_[pos_] == '\r' || data_[pos_] == '\t')) {
+        pos_++;
+    }
+}
+
+char json_reader::peek() {
+    skip_whitespace();
+    return pos_ < len_ ? data_[pos_] : 0;
+}
+
+bool json_reader::begin_object() {
+    if (peek() != '{') {
+        return fail();
+    }
+
+    pos_++;
+    return true;
+}
+
+bool json_reader::next_key(std::string &key) {
+    char c = peek();
+
+    if (c == '}') {
+        pos_++;
+        return false;
+    }
+    if (c == ',') {
+        pos_++;
+    }
+
+    if (!read_string(key) || peek() != ':') {
+        return fail();
+    }
+
+    pos_++;
+    return true;
+}
+
+bool json_reader::find(const char *key) {
+    std::string name;
+
+    if (!begin_object()) {
+        return false;
+    }
+
+    while (next_key(name)) {
+        if (name == key) {
+            return true;
+        }
+        if (!skip()) {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+bool json_reader::begin_array() {
+    if (peek() != '[') {
+        return fail();
+    }
+
+    pos_++;
+    return true;
+}
+
+bool json_reader::next_element() {
+    char c = peek();
+
+    if (c == ']') {
+        pos_++;
+        return false;
+    }
+    if (c == ',') {
+        pos_++;
+    }
+
+    return peek() != 0;
+}
+
+bool json_reader::skip_string() {
+    /* the opening quote has been consumed */
+    for (;;) {
+        const char *quote = (const char *)memchr(data_ + pos_, '"',
+            len_ - pos_);
+        if (!quote) {
+            return fail();
+        }
+
+        /* the quote is escaped if preceded by an odd number of
+         * backslashes */
+        size_t end = quote - data_;
+        size_t backslashes = 0;
+        while (end - backslashes > pos_ &&
+            data_[end - backslashes - 1] == '\\') {
+            backslashes++;
+        }
+
+        pos_ = end + 1;
+        if (backslashes % 2 == 0) {
+            return true;
+        }
+    }
+}
+
+static void append_utf8(std::string &value, unsigned int cp) {
+    if (cp < 0x80) {
+        value.push_back((char)cp);
+    }
+    else if (cp < 0x800) {
+        value.push_back((char)(0xc0 | (cp >> 6)));
+        value.push_back((char)(0x80 | (cp & 0x3f)));
+    }
+    else if (cp < 0x10000) {
+        value.push_back((char)(0xe0 | (cp >> 12)));
+        value.push_back((char)(0x80 | ((cp >> 6) & 0x3f)));
+        value.push_back((char)(0x80 | (cp & 0x3f)));
+    }
+    else {
+        value.push_back((char)(0xf0 | (cp >> 18)));
+        value.push_back((char)(0x80 | ((cp >> 12) & 0x3f)));
+        value.push_back((char)(0x80 | ((cp >> 6) & 0x3f)));
+        value.push_back((char)(0x80 | (cp & 0x3f)));
+    }
+}
+
+static bool read_hex4(const char *p, unsigned int *value) {
+    *value = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = p[i];
+        *value <<= 4;
+        if (c >= '0' && c <= '9') {
+            *value |= c - '0';
+        }
+        else if (c >= 'a' && c <= 'f') {
+            *value |= c - 'a' + 10;
+        }
+        else if (c >= 'A' && c <= 'F') {
+            *value |= c - 'A' + 10;
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool json_reader::read_scalar(std::string &value) {
+    char c = peek();
+
+    if (c == '"') {
+        return read_string(value);
+    }
+    if (c == 0 || c == '{' || c == '[') {
+        return false;
+    }
+
+    size_t start = pos_;
+    if (!skip()) {
+        return false;
+    }
+
+    value.assign(data_ + start, pos_ - start);
+    return true;
+}
+
+bool json_reader::read_string(std::string &value) {
+    if (peek() != '"') {
+        return false;
+    }
+
+    size_t start = ++pos_;
+    if (!skip_string()) {
+        return false;
+    }
+
+    size_t end = pos_ - 1;
+    const char *escape = (const char *)memchr(data_ + start, '\\',
+        end - start);
+
+    /* most strings do not contain escapes */
+    if (!escape) {
+        value.assign(data_ + start, end - start);
+        return true;
+    }
+
+    value.assign(data_ + start, escape - (data_ + start));
+    for (size_t i = escape - data_; i < end; i++) {
+        char c = data_[i];
+        if (c != '\\') {
+            value.push_back(c);
+            continue;
+        }
+
+        if (++i >= end) {
+            return fail();
+        }
+
+        unsigned int cp, low;
+        switch (data_[i]) {
+        case 'b': value.push_back('\b'); break;
+        case 'f': value.push_back('\f'); break;
+        case 'n': value.push_back('\n'); break;
+        case 'r': value.push_back('\r'); break;
+        case 't': value.push_back('\t'); break;
+        case 'u':
+            if (i + 4 >= end || !read_hex4(data_ + i + 1, &cp)) {
+                return fail();
+            }
+            i += 4;
+
+            /* combine surrogate pairs */
+            if (cp >= 0xd800 && cp < 0xdc00 && i + 6 < end &&
+                data_[i + 1] == '\\' && data_[i + 2] == 'u' &&
+                read_hex4(data_ + i + 3, &low) &&
+                low >= 0xdc00 && low < 0xe000) {
+                cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                i += 6;
+            }
+            append_utf8(value, cp);
+            break;
+        default:
+            value.push_back(data_[i]);
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool json_reader::skip() {
+    size_t depth = 0;
+
+    do {
+        char c = peek();
+
+        switch (c) {
+        case 0:
+            return fail();
+        case '"':
+            pos_++;
+            if (!skip_string()) {
+                return false;
+            }
+            break;
+        case '{':
+        case '[':
+            depth++;
+            pos_++;
+            break;
+        case '}':
+        case ']':
+            if (depth == 0) {
+                return fail();
+            }
+            depth--;
+            pos_++;
+            break;
+        case ',':
+        case ':':
+            if (depth == 0) {
+                return fail();
+            }
+            pos_++;
+            break;
+        default:
+            /* numbers and literals */
+            while (pos_ < len_ &&
+                strchr(",:]} \n\r\t\"", data_[pos_]) == NULL) {
+                pos_++;
+            }
+            break;
+        }
+    } while (depth > 0);
+
+    return true;
+}
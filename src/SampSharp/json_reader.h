@@ -0,0 +1,63 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <stddef.h>
+#include <string>
+
+/** a forward-only reader of a JSON document which does not build a tree.
+ * values must be consumed in document order: read, entered or skipped */
+class json_reader
+{
+public:
+    json_reader(const char *data, size_t len);
+    /** the first character of the next value or 0 at the end of the document
+     * or after an error */
+    char peek();
+    /** enters the object at the current position */
+    bool begin_object();
+    /** reads the key of the next member of the current object and moves to
+     * its value; false at the end of the object */
+    bool next_key(std::string &key);
+    /** enters the object at the current position and moves to the value of
+     * the member with the specified key; false if there is no such member */
+    bool find(const char *key);
+    /** enters the array at the current position */
+    bool begin_array();
+    /** moves to the next element of the current array; false at the end of
+     * the array */
+    bool next_element();
+    /** reads the string at the current position; false if the value is not a
+     * string, in which case it is not consumed */
+    bool read_string(std::string &value);
+    /** reads the string, number or literal at the current position; strings
+     * are unescaped, other values are read as written */
+    bool read_scalar(std::string &value);
+    /** skips the value at the current position */
+    bool skip();
+    size_t position() const { return pos_; }
+    void seek(size_t pos) { pos_ = pos < len_ ? pos : len_; }
+    bool failed() const { return failed_; }
+private:
+    void skip_whitespace();
+    bool skip_string();
+    bool fail();
+    const char *data_;
+    size_t len_;
+    size_t pos_;
+    bool failed_;
+};
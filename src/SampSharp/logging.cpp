@@ -13,10 +13,18 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+
 #include "logging.h"
+#include <atomic>
+#include <chrono>
 #include <cstdarg>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <stdio.h>
 #include <string.h>
+#include <inttypes.h>
 #include <sampgdk/sampgdk.h>
 #include "platforms.h"
 
@@ -26,25 +34,274 @@
 #endif
 
 #define LEN_PRINT_BUFFER    (1024)
+#define LOG_RING_SIZE       (256) /* must be a power of two */
+#define LOG_FLUSH_BATCH     (64) /* messages written per flush */
+#define LOG_REPEAT_WINDOW   (1000) /* ms in which repeats are suppressed */
+
+#ifdef LOG_DEBUG
+volatile int log_level_current = log_level_debug;
+#else
+volatile int log_level_current = log_level_info;
+#endif
+
+/** a queued message */
+struct log_entry {
+    std::atomic<uint32_t> sequence;
+    const char *prefix;
+    char text[LEN_PRINT_BUFFER];
+};
+
+/* bounded multi-producer single-consumer ring of messages. producers never
+ * block; if the ring is full the message is dropped and counted, except for
+ * printed output, which is never dropped. the server's
+ * logprintf is not thread-safe, so the main thread is the consumer.
+ */
+static log_entry ring_[LOG_RING_SIZE];
+static std::atomic<uint32_t> enqueue_pos_(0);
+static uint32_t dequeue_pos_ = 0;
+static std::atomic<uint32_t> dropped_(0);
+static std::atomic<bool> running_(false);
+/** number of producers which may still be writing a message */
+static std::atomic<uint32_t> producers_(0);
+/** the thread which consumes the ring */
+static std::thread::id main_thread_;
+
+/* printed output is never dropped; prints which don't fit in the ring are
+ * kept here until the next flush */
+static std::mutex spill_mutex_;
+static std::deque<std::string> spill_;
+
+/* repeated message suppression; only used by the consumer */
+static char last_text_[LEN_PRINT_BUFFER];
+static const char *last_prefix_ = NULL;
+static uint32_t repeats_ = 0;
+static std::chrono::steady_clock::time_point last_time_;
+
+/** writes a message to the server log */
+static void log_write(const char *prefix, const char *text) {
+    if (prefix) {
+        sampgdk_logprintf("[SampSharp:%s] %s", prefix, text);
+    }
+    else {
+        sampgdk_logprintf("%s", text);
+    }
+}
+
+/** writes a message unless it repeats the previous log message */
+static void write_filtered(const char *prefix, const char *text) {
+    std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+
+    if (prefix && prefix == last_prefix_ && !strcmp(text, last_text_) &&
+        now - last_time_ < std::chrono::milliseconds(LOG_REPEAT_WINDOW)) {
+        repeats_++;
+        return;
+    }
+
+    if (repeats_) {
+        sampgdk_logprintf("[SampSharp:INFO] Previous message repeated %u "
+            "times.", repeats_);
+        repeats_ = 0;
+    }
+
+    log_write(prefix, text);
+
+    last_prefix_ = prefix;
+    last_time_ = now;
+    strcpy(last_text_, text);
+}
+
+/** reserves a slot in the ring; NULL if the ring is full */
+static log_entry *enqueue_begin(uint32_t *pos) {
+    uint32_t p = enqueue_pos_.load(std::memory_order_relaxed);
+
+    for (;;) {
+        log_entry *entry = &ring_[p & (LOG_RING_SIZE - 1)];
+        int32_t diff = (int32_t)(entry->sequence.load(
+            std::memory_order_acquire) - p);
+
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(p, p + 1,
+                std::memory_order_relaxed)) {
+                *pos = p;
+                return entry;
+            }
+        }
+        else if (diff < 0) {
+            return NULL;
+        }
+        else {
+            p = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/** writes up to max queued messages; only called by the main thread */
+static void drain(uint32_t max) {
+    for (; max > 0; max--) {
+        log_entry *entry = &ring_[dequeue_pos_ & (LOG_RING_SIZE - 1)];
+
+        if (entry->sequence.load(std::memory_order_acquire) !=
+            dequeue_pos_ + 1) {
+            break;
+        }
+
+        write_filtered(entry->prefix, entry->text);
+
+        entry->sequence.store(dequeue_pos_ + LOG_RING_SIZE,
+            std::memory_order_release);
+        dequeue_pos_++;
+    }
+
+    std::deque<std::string> spill;
+    spill_mutex_.lock();
+    spill.swap(spill_);
+    spill_mutex_.unlock();
+
+    for (size_t i = 0; i < spill.size(); i++) {
+        write_filtered(NULL, spill[i].c_str());
+    }
+
+    uint32_t dropped = dropped_.exchange(0);
+    if (dropped) {
+        sampgdk_logprintf("[SampSharp:WARNING] %u log messages dropped.",
+            dropped);
+    }
+}
 
 /** log a message */
-void vlog(const char* prefix, const char *format, va_list args) {
-    char buffer[LEN_PRINT_BUFFER];
-    vsnprintf(buffer, LEN_PRINT_BUFFER, format, args);
-    buffer[LEN_PRINT_BUFFER - 1] = '\0';
+static void vlog(const char* prefix, const char *format, va_list args) {
+    uint32_t pos;
+    log_entry *entry;
+
+    /* counted before running_ is checked so log_stop waits for this
+     * message */
+    producers_++;
+
+    if (!running_.load()) {
+        producers_--;
 
-    sampgdk_logprintf("[SampSharp:%s] %s", prefix, buffer);
+        /* not started or stopped; write synchronously */
+        char buffer[LEN_PRINT_BUFFER];
+        vsnprintf(buffer, LEN_PRINT_BUFFER, format, args);
+        buffer[LEN_PRINT_BUFFER - 1] = '\0';
+
+        log_write(prefix, buffer);
+        return;
+    }
+
+    if (!prefix && std::this_thread::get_id() == main_thread_) {
+        /* prints on the main thread are written synchronously, after the
+         * messages queued before them */
+        char buffer[LEN_PRINT_BUFFER];
+        vsnprintf(buffer, LEN_PRINT_BUFFER, format, args);
+        buffer[LEN_PRINT_BUFFER - 1] = '\0';
+
+        drain(UINT32_MAX);
+        write_filtered(NULL, buffer);
+
+        producers_--;
+        return;
+    }
+
+    if (!(entry = enqueue_begin(&pos))) {
+        if (!prefix) {
+            char buffer[LEN_PRINT_BUFFER];
+            vsnprintf(buffer, LEN_PRINT_BUFFER, format, args);
+            buffer[LEN_PRINT_BUFFER - 1] = '\0';
+
+            spill_mutex_.lock();
+            spill_.push_back(buffer);
+            spill_mutex_.unlock();
+        }
+        else {
+            dropped_++;
+        }
+        producers_--;
+        return;
+    }
+
+    vsnprintf(entry->text, LEN_PRINT_BUFFER, format, args);
+    entry->text[LEN_PRINT_BUFFER - 1] = '\0';
+    entry->prefix = prefix;
+    entry->sequence.store(pos + 1, std::memory_order_release);
+
+    producers_--;
+}
+
+void log_set_level(const char *name) {
+    static const char *names[] = { "debug", "info", "warning", "error",
+        "none" };
+
+    if (!name || !*name) {
+        return;
+    }
+
+    for (int i = log_level_debug; i <= log_level_none; i++) {
+        if (!strcmp(name, names[i])) {
+            log_level_current = i;
+            return;
+        }
+    }
+
+    log_warning("Unknown log level '%s'.", name);
+}
+
+void log_start() {
+    if (running_.load()) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < LOG_RING_SIZE; i++) {
+        ring_[i].sequence.store(i + enqueue_pos_.load(),
+            std::memory_order_relaxed);
+    }
+    dequeue_pos_ = enqueue_pos_.load();
+    main_thread_ = std::this_thread::get_id();
+
+    running_.store(true);
+}
+
+void log_flush() {
+    if (running_.load()) {
+        drain(LOG_FLUSH_BATCH);
+    }
+}
+
+void log_stop() {
+    if (!running_.load()) {
+        return;
+    }
+
+    running_.store(false);
+
+    /* producers which saw running_ may still be writing their message */
+    while (producers_.load()) {
+        std::this_thread::yield();
+    }
+
+    drain(UINT32_MAX);
+
+    if (repeats_) {
+        sampgdk_logprintf("[SampSharp:INFO] Previous message repeated %u "
+            "times.", repeats_);
+        repeats_ = 0;
+    }
 }
 
 void log_print(const char *format, ...) {
     va_list args;
     va_start(args, format);
-    sampgdk_vlogprintf(format, args);
+    vlog(NULL, format, args);
     va_end(args);
 }
 
 /** log error */
 void log_error(const char * format, ...) {
+    if (!log_enabled(log_level_error)) {
+        return;
+    }
+
     va_list args;
     va_start(args, format);
     vlog("ERROR", format, args);
@@ -53,6 +310,10 @@ void log_error(const char * format, ...) {
 
 /** log error */
 void log_warning(const char * format, ...) {
+    if (!log_enabled(log_level_warning)) {
+        return;
+    }
+
     va_list args;
     va_start(args, format);
     vlog("WARNING", format, args);
@@ -61,6 +322,10 @@ void log_warning(const char * format, ...) {
 
 /** log debug */
 void log_debug2(const char * format, ...) {
+    if (!log_enabled(log_level_debug)) {
+        return;
+    }
+
     va_list args;
     va_start(args, format);
     vlog("DEBUG", format, args);
@@ -69,6 +334,10 @@ void log_debug2(const char * format, ...) {
 
 /** log info */
 void log_info(const char * format, ...) {
+    if (!log_enabled(log_level_info)) {
+        return;
+    }
+
     va_list args;
     va_start(args, format);
     vlog("INFO", format, args);
@@ -13,11 +13,40 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+
 #pragma once
 
+/** log levels; messages below the current level are discarded */
+enum log_level {
+    log_level_debug     = 0,
+    log_level_info      = 1,
+    log_level_warning   = 2,
+    log_level_error     = 3,
+    log_level_none      = 4,
+};
+
+extern volatile int log_level_current;
+
+/** a value indicating whether messages of the specified level are logged */
+#define log_enabled(level) ((level) >= log_level_current)
+
+/** sets the log level by name (debug, info, warning, error or none) */
+void log_set_level(const char *name);
+
+/** starts queueing messages; queued messages are written by log_flush */
+void log_start();
+
+/** writes a bounded number of queued messages; the server's log is not
+ * thread-safe, so this is only called on the main thread */
+void log_flush();
+
+/** writes all queued messages and stops queueing; called on the main thread */
+void log_stop();
+
 void log_debug2(const char *format, ...);
 
-/** prints text to the output */
+/** prints text to the output; written immediately on the main thread and
+ * never dropped */
 void log_print(const char *format, ...);
 
 /** log an error */
@@ -28,6 +28,7 @@
 using sampgdk::logprintf;
 
 server *svr = NULL;
+hosted_server *booting = NULL;
 commsvr *com = NULL;
 plugin *plg = NULL;
 
@@ -39,6 +40,16 @@ void print_info() {
     log_print("");
 }
 
+hosted_server *create_hosted_server() {
+    std::string coreclr;
+    std::string gamemode;
+
+    plg->config("coreclr", coreclr);
+    plg->config("gamemode", gamemode);
+
+    return new hosted_server(plg, coreclr.c_str(), gamemode.c_str());
+}
+
 void start_server() {
     if(!(plg->state() & STATE_INITIALIZED)) {
         /* workaround for SA-MP error which prevents OnRconCommand from working
@@ -52,18 +63,25 @@ void start_server() {
     }
 
     if(svr) {
+        /* CoreCLR can not be initialized twice in one process; the hosted
+         * server survives game mode restarts */
+        if(plg->state() & STATE_HOSTED) {
+            return;
+        }
+
         delete svr;
         svr = NULL;
     }
 
     if(plg->state() & STATE_HOSTED) {
-        std::string coreclr;
-        std::string gamemode;
-
-        plg->config("coreclr", coreclr);
-        plg->config("gamemode", gamemode);
-
-        svr = new hosted_server(coreclr.c_str(), gamemode.c_str());
+        if (booting) {
+            /* the runtime has been initializing since the plugin loaded */
+            svr = booting;
+            booting = NULL;
+        }
+        else {
+            svr = create_hosted_server();
+        }
     }
     else {
         com = plg->create_commsvr();
@@ -88,8 +106,24 @@ PLUGIN_EXPORT bool PLUGIN_CALL Load(void **ppData) {
 
     plg = new plugin(ppData);
 
+    std::string level;
+    plg->config("log_level", level);
+    log_set_level(level.c_str());
+    log_start();
+
     /* validate the server config is fit for running SampSharp */
-    return plg && plg->config_validate();
+    if (!plg || !plg->config_validate()) {
+        /* no ticks follow to write the queued messages */
+        log_stop();
+        return false;
+    }
+
+    /* initialize the runtime while the server boots */
+    if (plg->state() & STATE_HOSTED) {
+        booting = create_hosted_server();
+    }
+
+    return true;
 }
 
 PLUGIN_EXPORT void PLUGIN_CALL Unload() {
@@ -98,12 +132,16 @@ PLUGIN_EXPORT void PLUGIN_CALL Unload() {
     }
     
     delete svr;
+    delete booting;
     delete com;
     delete plg;
     
     plg = NULL;
     svr = NULL;
+    booting = NULL;
     com = NULL;
+
+    log_stop();
     
     sampgdk::Unload();
 }
@@ -113,6 +151,9 @@ PLUGIN_EXPORT void PLUGIN_CALL ProcessTick() {
     if (svr) {
         svr->tick();
     }
+
+    /* queued messages are written after the tick's work is done */
+    log_flush();
 }
 
 PLUGIN_EXPORT bool PLUGIN_CALL OnPublicCall(AMX *amx, const char *name,
@@ -15,18 +15,22 @@
 
 #include "message_queue.h"
 #include <assert.h>
+#include <algorithm>
 
 message_queue::message_queue() : 
-    local_fill_(false)
+    local_fill_(false),
+    discard_(0)
 {
 }
 
 void message_queue::add(uint8_t *buf, uint32_t len) {
     assert(buf);
 
-    for (uint32_t i = 0; i < len; i++) {
-        queue_.push_back(buf[i]);
-    }
+    /* the bytes of a rejected frame are never buffered */
+    uint32_t skip = std::min(discard_, len);
+    discard_ -= skip;
+
+    queue_.insert(queue_.end(), buf + skip, buf + len);
 }
 
 bool message_queue::can_get() {
@@ -34,7 +38,9 @@ bool message_queue::can_get() {
         return false;
     }
 
-    return queue_.size() >= command_length_;
+    /* a rejected frame is reported without waiting for its bytes */
+    return command_length_ > MESSAGE_QUEUE_MAX_LENGTH ||
+        queue_.size() >= command_length_;
 }
 
 uint32_t message_queue::get(uint8_t *command, uint8_t *buf, uint32_t len) {
@@ -45,26 +51,39 @@ uint32_t message_queue::get(uint8_t *command, uint8_t *buf, uint32_t len) {
         return 0;
     }
 
-    if (command_length_ > len) {
-        for (uint32_t i = 0; i < command_length_; i++) {
-            pop();
-        }
+    if (command_length_ > MESSAGE_QUEUE_MAX_LENGTH) {
+        local_fill_ = false;
+
+        return MESSAGE_QUEUE_FRAME_TOO_LARGE;
+    }
 
+    /* leave the message in the queue so it can be retrieved again using a
+     * larger buffer */
+    if (command_length_ > len) {
         return MESSAGE_QUEUE_BUFFER_TOO_SMALL;
     }
+
     *command = command_;
-    for (uint32_t i = 0; i < command_length_; i++) {
-        buf[i] = pop();
-    }
+    std::copy(queue_.begin(), queue_.begin() + command_length_, buf);
+    queue_.erase(queue_.begin(), queue_.begin() + command_length_);
 
     local_fill_ = false;
 
     return command_length_;
 }
 
+uint32_t message_queue::length() {
+    if (!try_fill_local()) {
+        return 0;
+    }
+
+    return command_length_;
+}
+
 void message_queue::clear() {
     queue_.clear();
     local_fill_ = false;
+    discard_ = 0;
 }
 
 bool message_queue::try_fill_local() {
@@ -84,6 +103,15 @@ bool message_queue::try_fill_local() {
         ((uint32_t)pop() << 16) |
         ((uint32_t)pop() << 24));
 
+    /* reject oversized frames as soon as the header is parsed; the bytes
+     * already received are dropped and the rest is dropped as it arrives */
+    if (command_length_ > MESSAGE_QUEUE_MAX_LENGTH) {
+        uint32_t skip = (uint32_t)std::min((size_t)command_length_,
+            queue_.size());
+        queue_.erase(queue_.begin(), queue_.begin() + skip);
+        discard_ = command_length_ - skip;
+    }
+
     return true;
 }
 
@@ -19,6 +19,8 @@
 #include <deque>
 
 #define MESSAGE_QUEUE_BUFFER_TOO_SMALL  0xffffffffu
+#define MESSAGE_QUEUE_FRAME_TOO_LARGE   0xfffffffeu
+#define MESSAGE_QUEUE_MAX_LENGTH        (1024 * 1024 * 16)
 
 class message_queue
 {
@@ -27,12 +29,15 @@ public:
     void add(uint8_t *buf, uint32_t len);
     bool can_get();
     uint32_t get(uint8_t *command, uint8_t *buf, uint32_t len);
+    uint32_t length();
     void clear();
 private:
     std::deque<uint8_t> queue_;
     uint8_t command_;
     uint32_t command_length_;
     bool local_fill_;
+    /** remaining bytes of a rejected frame which are discarded on arrival */
+    uint32_t discard_;
     bool try_fill_local();
     uint8_t pop();
 };
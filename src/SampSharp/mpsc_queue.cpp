@@ -0,0 +1,70 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mpsc_queue.h"
+#include <stddef.h>
+
+mpsc_queue::mpsc_queue() :
+    head_(&stub_),
+    tail_(&stub_) {
+    stub_.next.store(NULL, std::memory_order_relaxed);
+}
+
+void mpsc_queue::push(mpsc_node *node) {
+    node->next.store(NULL, std::memory_order_relaxed);
+
+    /* a producer preempted between the exchange and the store leaves the
+     * queue disconnected until it links its node */
+    mpsc_node *prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+mpsc_node *mpsc_queue::pop() {
+    mpsc_node *tail = tail_;
+    mpsc_node *next = tail->next.load(std::memory_order_acquire);
+
+    /* skip the stub */
+    if (tail == &stub_) {
+        if (next == NULL) {
+            return NULL;
+        }
+
+        tail_ = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next != NULL) {
+        tail_ = next;
+        return tail;
+    }
+
+    if (tail != head_.load(std::memory_order_acquire)) {
+        return NULL;
+    }
+
+    /* the tail is the last node; put the stub behind it so it can be
+     * removed */
+    push(&stub_);
+
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != NULL) {
+        tail_ = next;
+        return tail;
+    }
+
+    return NULL;
+}
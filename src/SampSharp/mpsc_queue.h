@@ -0,0 +1,44 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <atomic>
+
+/** a node of a multiple producer, single consumer queue; the queue does not
+ * own its nodes */
+struct mpsc_node {
+    std::atomic<mpsc_node *> next;
+};
+
+/** an unbounded, lock-free queue of intrusive nodes. any thread may push; only
+ * a single thread may pop */
+class mpsc_queue
+{
+public:
+    mpsc_queue();
+    /** appends a node to the queue */
+    void push(mpsc_node *node);
+    /** removes the oldest node from the queue; NULL if the queue is empty or
+     * a push has not completed yet */
+    mpsc_node *pop();
+private:
+    mpsc_queue(const mpsc_queue &);
+    mpsc_queue &operator=(const mpsc_queue &);
+    std::atomic<mpsc_node *> head_;
+    mpsc_node *tail_;
+    mpsc_node stub_;
+};
@@ -18,7 +18,10 @@
 #include "remote_server.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
+#include <chrono>
+#include <sstream>
 #include "logging.h"
 
 #define MAX_ARGS                (128)
@@ -31,6 +34,16 @@
 #define ARG_STRING              (4)
 #define ARG_STRING_REF          (12)/* require size */
 
+natives_map::natives_map() :
+    tick_(0) {
+}
+
+/** the current time in milliseconds */
+static uint64_t time_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 int32_t natives_map::get_handle(const char *name) {
     /* check for the native in the map */
     std::map<std::string, int32_t>::const_iterator it = 
@@ -50,20 +63,29 @@ int32_t natives_map::get_handle(const char *name) {
     natives_.push_back(native);
     natives_map_[name] = handle;
 
+    cache c = cache();
+    std::map<std::string, std::pair<native_cache_policy, uint32_t> >::
+        const_iterator cfg = cache_config_.find(name);
+    if (cfg != cache_config_.end()) {
+        c.policy = cfg->second.first;
+        c.ttl = cfg->second.second;
+        log_debug("Caching results of native %s.", name);
+    }
+    caches_.push_back(c);
+
     return handle;
 }
 
-void natives_map::invoke(uint8_t *rxbuf, uint32_t rxlen, uint8_t *txbuf, 
+bool natives_map::invoke(uint8_t *rxbuf, uint32_t rxlen, uint8_t *txbuf, 
     uint32_t *txlen) {
     assert(rxbuf);
     assert(rxlen);
     assert(txbuf);
     assert(txlen);
 
-#define STOP_ERR(err, ...) *txlen = 0; log_error(err, ##__VA_ARGS__); return
+#define STOP_ERR(err, ...) *txlen = 0; log_error(err, ##__VA_ARGS__); return false
 #define ARG_LEN() *(uint32_t *)(rxbuf + rxpos)
-#define ARG_BUF_REQUIRE(len); \
-    if (*txlen < txpos + (len)) {STOP_ERR("Native output buffer is full.");}
+#define ARG_BUF_REQUIRE(len) overflow = overflow || *txlen < txpos + (len)
 #define ARG_FORMAT_ADD(c) sampsharp_strcat(format, MAX_ARGS_FORMAT, c)
 #define ARG_FORMAT_ADDF(c, ...) sampsharp_sprintf(formattmp,MAX_ARGS_FORMAT, c,\
     ##__VA_ARGS__); sampsharp_strcat(format, MAX_ARGS_FORMAT, formattmp)
@@ -72,6 +94,7 @@ void natives_map::invoke(uint8_t *rxbuf, uint32_t rxlen, uint8_t *txbuf,
         arglen,
         txpos = sizeof(uint32_t); /* space for response */
     int32_t handle = *(int32_t *)rxbuf;
+    bool overflow = *txlen < txpos;
     void* args[MAX_ARGS];
     char format[MAX_ARGS_FORMAT] = { 0 };
     char formattmp[MAX_ARGS_FORMAT];
@@ -80,6 +103,17 @@ void natives_map::invoke(uint8_t *rxbuf, uint32_t rxlen, uint8_t *txbuf,
         STOP_ERR("Invoking invalid native handle.");
     }
 
+    /* answer from the cache; the key is the raw argument buffer */
+    std::string key;
+    bool cached = caches_[handle].policy != cache_none;
+    if (cached) {
+        key.assign((char *)rxbuf + sizeof(int32_t), rxlen - sizeof(int32_t));
+
+        if (cache_get(handle, key, txbuf, txlen)) {
+            return true;
+        }
+    }
+
     for (uint32_t rxpos = sizeof(uint32_t) + 1, j = 0; rxpos < rxlen; j++, 
         rxpos++) {
         if (j >= MAX_ARGS) {
@@ -99,7 +133,9 @@ void natives_map::invoke(uint8_t *rxbuf, uint32_t rxlen, uint8_t *txbuf,
                 ARG_FORMAT_ADD("R");
 
                 args[j] = txbuf + txpos;
-                memcpy(txbuf + txpos, rxbuf + rxpos, sizeof(uint32_t));
+                if (!overflow) {
+                    memcpy(txbuf + txpos, rxbuf + rxpos, sizeof(uint32_t));
+                }
 
                 txpos += sizeof(uint32_t);
                 rxpos += sizeof(uint32_t);
@@ -116,7 +152,9 @@ void natives_map::invoke(uint8_t *rxbuf, uint32_t rxlen, uint8_t *txbuf,
                 ARG_FORMAT_ADDF("S[%d]", arglen);
 
                 args[j] = txbuf + txpos;
-                *(char *)args[j] = '\0';
+                if (!overflow) {
+                    *(char *)args[j] = '\0';
+                }
 
                 txpos += arglen;
                 rxpos += sizeof(uint32_t);
@@ -131,11 +169,13 @@ void natives_map::invoke(uint8_t *rxbuf, uint32_t rxlen, uint8_t *txbuf,
                 break;
             case ARG_ARRAY_REF:
                 arglen = ARG_LEN();
-                ARG_BUF_REQUIRE(arglen);
+                ARG_BUF_REQUIRE(arglen * sizeof(uint32_t));
                 ARG_FORMAT_ADDF("A[%d]", arglen);
 
                 args[j] = txbuf + txpos;
-                memset(txbuf + txpos, 0, arglen * sizeof(uint32_t));
+                if (!overflow) {
+                    memset(txbuf + txpos, 0, arglen * sizeof(uint32_t));
+                }
 
                 txpos += arglen * sizeof(uint32_t);
                 rxpos += sizeof(uint32_t);
@@ -145,12 +185,238 @@ void natives_map::invoke(uint8_t *rxbuf, uint32_t rxlen, uint8_t *txbuf,
         }
     }
 
+    /* let the caller retry with a buffer of the required size */
     *txlen = txpos;
+    if (overflow) {
+        return false;
+    }
+
     *(uint32_t*)txbuf = sampgdk::InvokeNativeArray(natives_[handle], format,
                                                    args);
+
+    if (cached) {
+        cache_put(handle, key, txbuf, txpos);
+    }
+    return true;
+}
+
+bool natives_map::invoke_values(int32_t handle, const cell *args,
+    uint32_t count, cell *result) {
+    cell params[MAX_ARGS + 1];
+
+    if (handle < 0 || handle >= (int32_t)natives_.size()) {
+        log_error("Invoking invalid native handle.");
+        return false;
+    }
+
+    if (count > MAX_ARGS) {
+        log_error("Too many native arguments.");
+        return false;
+    }
+
+    /* share cached results with invoke; build the same key */
+    std::string key;
+    bool cached = caches_[handle].policy != cache_none;
+    if (cached) {
+        uint32_t len = sizeof(cell);
+
+        key.reserve(count * (sizeof(cell) + 1));
+        for (uint32_t i = 0; i < count; i++) {
+            key.push_back((char)ARG_VALUE);
+            key.append((const char *)(args + i), sizeof(cell));
+        }
+
+        if (cache_get(handle, key, (uint8_t *)result, &len)) {
+            return true;
+        }
+    }
+
+    /* values need no conversion; call the native with the arguments as its
+     * parameters */
+    params[0] = count * sizeof(cell);
+    memcpy(params + 1, args, count * sizeof(cell));
+
+    *result = sampgdk::CallNative(natives_[handle], params);
+
+    if (cached) {
+        cache_put(handle, key, (uint8_t *)result, sizeof(cell));
+    }
+    return true;
+}
+
+void natives_map::invoke_batch(uint8_t *rxbuf, uint32_t rxlen,
+    uint8_t *txbuf, uint32_t *txlen) {
+    /* format: rx [u32 len][call]...; tx [u32 count][u32 len][response]...
+     * where count is the number of natives invoked */
+    uint32_t
+        rxpos = 0,
+        txpos = sizeof(uint32_t),
+        count = 0,
+        len,
+        response_len;
+
+    if (*txlen < txpos) {
+        *txlen = 0;
+        return;
+    }
+
+    while (rxpos + sizeof(uint32_t) <= rxlen) {
+        memcpy(&len, rxbuf + rxpos, sizeof(uint32_t));
+        rxpos += sizeof(uint32_t);
+
+        if (len < sizeof(int32_t) || len > rxlen - rxpos ||
+            *txlen - txpos < sizeof(uint32_t)) {
+            break;
+        }
+
+        response_len = *txlen - txpos - sizeof(uint32_t);
+        if (!invoke(rxbuf + rxpos, len, txbuf + txpos + sizeof(uint32_t),
+            &response_len)) {
+            if (response_len) {
+                /* the native was not invoked; the caller sends the
+                 * remaining natives again */
+                break;
+            }
+
+            /* invalid calls are skipped with an empty response */
+        }
+
+        memcpy(txbuf + txpos, &response_len, sizeof(uint32_t));
+        txpos += sizeof(uint32_t) + response_len;
+        rxpos += len;
+        count++;
+    }
+
+    memcpy(txbuf, &count, sizeof(uint32_t));
+    *txlen = txpos;
+}
+
+bool natives_map::cache_get(int32_t handle, const std::string &key,
+    uint8_t *txbuf, uint32_t *txlen) {
+    cache &c = caches_[handle];
+    std::map<std::string, cache_entry>::iterator it = c.entries.find(key);
+
+    if (it == c.entries.end() ||
+        (c.policy == cache_tick && it->second.tick != tick_) ||
+        (c.policy == cache_ttl && it->second.expires <= time_ms()) ||
+        it->second.result.length() > *txlen) {
+        c.misses++;
+        return false;
+    }
+
+    c.hits++;
+    it->second.used = ++c.uses;
+    *txlen = it->second.result.length();
+    memcpy(txbuf, it->second.result.data(), *txlen);
+    return true;
+}
+
+void natives_map::cache_put(int32_t handle, const std::string &key,
+    uint8_t *txbuf, uint32_t txlen) {
+    cache &c = caches_[handle];
+
+    /* keep the cache of natives with many distinct arguments bounded by
+     * evicting the least recently used entry */
+    if (c.entries.size() >= NATIVE_CACHE_MAX_ENTRIES &&
+        c.entries.find(key) == c.entries.end()) {
+        std::map<std::string, cache_entry>::iterator it = c.entries.begin();
+        std::map<std::string, cache_entry>::iterator lru = it;
+
+        for (; it != c.entries.end(); it++) {
+            if (it->second.used < lru->second.used) {
+                lru = it;
+            }
+        }
+
+        c.entries.erase(lru);
+    }
+
+    cache_entry &entry = c.entries[key];
+    entry.used = ++c.uses;
+    entry.result.assign((char *)txbuf, txlen);
+    entry.tick = tick_;
+    entry.expires = c.policy == cache_ttl ? time_ms() + c.ttl : 0;
+}
+
+void natives_map::set_cache(int32_t handle, native_cache_policy policy,
+    uint32_t ttl) {
+    if (handle < 0 || handle >= (int32_t)caches_.size()) {
+        log_error("Setting cache policy of invalid native handle.");
+        return;
+    }
+
+    cache &c = caches_[handle];
+    c.policy = policy;
+    c.ttl = ttl;
+    c.entries.clear();
+}
+
+void natives_map::load_cache_config(const std::string &value) {
+    /* format: name=permanent|tick|<ttl in ms> separated by spaces */
+    std::istringstream stream(value);
+    std::string pair;
+
+    while (stream >> pair) {
+        size_t sep = pair.find('=');
+        if (sep == std::string::npos) {
+            log_warning("Invalid native cache configuration '%s'.",
+                pair.c_str());
+            continue;
+        }
+
+        std::string name = pair.substr(0, sep);
+        std::string policy = pair.substr(sep + 1);
+
+        if (policy == "permanent") {
+            cache_config_[name] = std::make_pair(cache_permanent, 0u);
+        }
+        else if (policy == "tick") {
+            cache_config_[name] = std::make_pair(cache_tick, 0u);
+        }
+        else if (atoi(policy.c_str()) > 0) {
+            cache_config_[name] = std::make_pair(cache_ttl,
+                (uint32_t)atoi(policy.c_str()));
+        }
+        else {
+            log_warning("Invalid native cache policy '%s' for %s.",
+                policy.c_str(), name.c_str());
+        }
+    }
+}
+
+void natives_map::tick() {
+    tick_++;
+}
+
+void natives_map::cache_log_stats() {
+    for (std::map<std::string, int32_t>::const_iterator it =
+        natives_map_.begin(); it != natives_map_.end(); it++) {
+        const cache &c = caches_[it->second];
+
+        if (c.policy == cache_none || c.hits + c.misses == 0) {
+            continue;
+        }
+
+        log_info("Native cache %s: %u hits, %u misses (%.1f%% hit rate).",
+            it->first.c_str(), c.hits, c.misses,
+            100.0 * c.hits / (c.hits + c.misses));
+    }
+}
+
+void natives_map::reset() {
+    cache_log_stats();
+
+    for (size_t i = 0; i < caches_.size(); i++) {
+        caches_[i].hits = 0;
+        caches_[i].misses = 0;
+        caches_[i].entries.clear();
+    }
 }
 
 void natives_map::clear() {
+    cache_log_stats();
+
     natives_.clear();
+    caches_.clear();
     natives_map_.clear();
 }
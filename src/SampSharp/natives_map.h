@@ -22,16 +22,69 @@
 #include <sampgdk/sampgdk.h>
 
 #define NATIVE_NOT_FOUND        -1
+#define NATIVE_CACHE_MAX_ENTRIES    (1024)
+
+/** caching policies of native results */
+enum native_cache_policy {
+    cache_none      = 0, /* always invoke the native */
+    cache_permanent = 1, /* results never change */
+    cache_tick      = 2, /* results are valid until the next tick */
+    cache_ttl       = 3, /* results are valid for a number of milliseconds */
+};
 
 class remote_server;
 
 class natives_map
 {
 public:
+    natives_map();
     int32_t get_handle(const char *name);
-    void invoke(uint8_t *rxbuf, uint32_t rxlen, uint8_t *txbuf, uint32_t *txlen);
+    /** invokes a native; if txbuf is too small, false is returned and txlen
+     * is set to the required length */
+    bool invoke(uint8_t *rxbuf, uint32_t rxlen, uint8_t *txbuf, uint32_t *txlen);
+    /** invokes a native taking only value arguments; returns false if the
+     * native could not be invoked */
+    bool invoke_values(int32_t handle, const cell *args, uint32_t count,
+        cell *result);
+    /** invokes a sequence of natives; stops at the first native of which the
+     * response does not fit txbuf */
+    void invoke_batch(uint8_t *rxbuf, uint32_t rxlen, uint8_t *txbuf,
+        uint32_t *txlen);
+    /** sets the caching policy of the native with the specified handle */
+    void set_cache(int32_t handle, native_cache_policy policy, uint32_t ttl);
+    /** loads caching policies from a list of name=policy pairs */
+    void load_cache_config(const std::string &value);
+    /** expires results cached for a single tick */
+    void tick();
+    /** drops cached results; handles and caching policies are kept */
+    void reset();
     void clear();
 private:
+    struct cache_entry {
+        std::string result;
+        uint32_t tick;
+        uint64_t expires;
+        /** value of the cache's use counter when last used */
+        uint64_t used;
+    };
+    struct cache {
+        native_cache_policy policy;
+        uint32_t ttl;
+        uint32_t hits;
+        uint32_t misses;
+        uint64_t uses;
+        std::map<std::string, cache_entry> entries;
+    };
+
+    bool cache_get(int32_t handle, const std::string &key, uint8_t *txbuf,
+        uint32_t *txlen);
+    void cache_put(int32_t handle, const std::string &key, uint8_t *txbuf,
+        uint32_t txlen);
+    void cache_log_stats();
+
     std::vector<AMX_NATIVE> natives_;
+    std::vector<cache> caches_;
     std::map<std::string,int32_t> natives_map_;
+    std::map<std::string,std::pair<native_cache_policy, uint32_t> > cache_config_;
+    uint32_t tick_;
 };
@@ -26,6 +26,7 @@
 #elif SAMPSHARP_LINUX
 #  include <unistd.h>
 #  include <dirent.h>
+#  include <sys/stat.h>
 #endif
 
 #if !defined(PATH_MAX) && defined(MAX_PATH)
@@ -124,6 +125,35 @@ bool file_exists(const char *path) {
 #endif
 }
 
+bool path_mtime(const char *path, uint64_t *mtime) {
+#if SAMPSHARP_WINDOWS
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data)) {
+        return false;
+    }
+
+    *mtime = ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) |
+        data.ftLastWriteTime.dwLowDateTime;
+    return true;
+#elif SAMPSHARP_LINUX
+    struct stat sb;
+    if (stat(path, &sb) == -1) {
+        return false;
+    }
+
+    *mtime = (uint64_t)sb.st_mtim.tv_sec * 1000000000 + sb.st_mtim.tv_nsec;
+    return true;
+#endif
+}
+
+bool file_replace(const char *from, const char *to) {
+#if SAMPSHARP_WINDOWS
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) != 0;
+#elif SAMPSHARP_LINUX
+    return rename(from, to) == 0;
+#endif
+}
+
 bool get_absolute_path(const char *path, std::string &absolute_path) {
     char cpath[PATH_MAX];
 
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <string>
+#include <inttypes.h>
 #include "platforms.h"
 
 #if SAMPSHARP_LINUX
@@ -33,6 +34,10 @@ void path_change_extension(const char *path, const char *ext, std::string &resul
 void path_append(const char *path, const char *append, std::string &result);
 bool dir_exists(const char *path);
 bool file_exists(const char *path);
+/** gets the last modification time of a file or directory */
+bool path_mtime(const char *path, uint64_t *mtime);
+/** replaces a file by another file in a single step */
+bool file_replace(const char *from, const char *to);
 bool get_directory(const char *absolute_path, std::string &directory);
 bool get_absolute_path(const char* path, std::string &absolute_path);
 void get_cwd(std::string &directory);
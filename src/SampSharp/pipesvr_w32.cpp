@@ -172,35 +172,42 @@ cmd_status pipesvr_win32::receive(uint8_t *command, uint8_t *buf,
         return conn_dead;
     }
 
-    //Read from client
+    //Read from client; keep reading while the read buffer is filled up
     DWORD rlen = 0;
-    if (!ReadFile(pipe_, buf_, LEN_NETBUF, &rlen, NULL)) {
-        DWORD error = GetLastError();
-        if (error == ERROR_NO_DATA) {
-            rlen = 0;
-        }
-        else {
-            rlen = 0;
-            log_error("Failed to read from pipe with error 0x%x.", error);
-            svr_->terminate("Failed to read from pipe.");
+    do {
+        if (!ReadFile(pipe_, buf_, LEN_NETBUF, &rlen, NULL)) {
+            DWORD error = GetLastError();
+            if (error == ERROR_NO_DATA) {
+                rlen = 0;
+            }
+            else {
+                rlen = 0;
+                log_error("Failed to read from pipe with error 0x%x.", error);
+                svr_->terminate("Failed to read from pipe.");
+            }
         }
-    }
 
-
-    if (rlen > 0) {
-        queue_messages_.add(buf_, rlen);
-    }
+        if (rlen > 0) {
+            queue_messages_.add(buf_, rlen);
+        }
+    } while (rlen == LEN_NETBUF && !queue_messages_.can_get());
 
     if (!queue_messages_.can_get()) {
         return no_cmd;
     }
 
-    *len = queue_messages_.get(command, buf, *len);
-    if (*len == MESSAGE_QUEUE_BUFFER_TOO_SMALL) {
-        log_error("Message buffer too small.");
-        len = 0;
+    uint32_t result = queue_messages_.get(command, buf, *len);
+    if (result == MESSAGE_QUEUE_BUFFER_TOO_SMALL) {
+        *len = queue_messages_.length();
+        return too_small;
+    }
+    if (result == MESSAGE_QUEUE_FRAME_TOO_LARGE) {
+        log_error("Message too large.");
+        *len = 0;
+        return no_cmd;
     }
 
+    *len = result;
     return unhandled;
 }
 
@@ -52,6 +52,8 @@ bool plugin::config_validate() {
     std::string
         coreclr,
         coreclr_path,
+        hostfxr,
+        nativeaot,
         gamemode;
 
     /* check whether gamemodeN values contain acceptable values. */
@@ -81,9 +83,14 @@ bool plugin::config_validate() {
     }
     
     config("coreclr", coreclr);
+    config("hostfxr", hostfxr);
+    config("nativeaot", nativeaot);
     config("gamemode", gamemode);
 
-    if(coreclr.length() > 0 && gamemode.length() > 0) {
+    bool aot = nativeaot == "1" || nativeaot == "true";
+
+    if((coreclr.length() > 0 || hostfxr.length() > 0 || aot) &&
+        gamemode.length() > 0) {
         state_set(STATE_HOSTED);
     }
 
@@ -92,6 +99,30 @@ bool plugin::config_validate() {
         return true;
     }
 
+    if(!file_exists(gamemode.c_str())) {
+        log_error("Invalid gamemode specified in server.cfg.");
+        log_error("File could not be found.");
+        return false;
+    }
+
+    // A NativeAOT compiled game mode contains the runtime.
+    if(aot) {
+        state_set(STATE_CONFIG_VALID);
+        return true;
+    }
+
+    // The runtime is resolved by hostfxr if it has been specified.
+    if(hostfxr.length() > 0) {
+        if(!dir_exists(hostfxr.c_str()) && !file_exists(hostfxr.c_str())) {
+            log_error("Invalid hostfxr path specified in server.cfg.");
+            log_error("File could not be found.");
+            return false;
+        }
+
+        state_set(STATE_CONFIG_VALID);
+        return true;
+    }
+
     // Verify hosting config values if coreclr has been specified.
     if(!dir_exists(coreclr.c_str())) {
         log_error("Invalid coreclr directory specified in server.cfg.");
@@ -106,12 +137,6 @@ bool plugin::config_validate() {
         log_error(CORECLR_LIB " could not be found.");
         return false;
     }
-
-    if(!file_exists(gamemode.c_str())) {
-        log_error("Invalid gamemode specified in server.cfg.");
-        log_error("File could not be found.");
-        return false;
-    }
     
     state_set(STATE_CONFIG_VALID);
     return true; 
@@ -21,6 +21,7 @@
 #include <string.h>
 #include "logging.h"
 #include "pathutil.h"
+#include "startup_timer.h"
 
 #define DEBUG_PAUSE_TIMEOUT         (5)
 #define DEBUG_PAUSE_TICK_INTERVAL   (7)
@@ -36,6 +37,12 @@
 #define CMD_INVOKE_NATIVE   (0x07) /* invoke a native */
 #define CMD_START           (0x08) /* start sending messages*/
 #define CMD_DISCONNECT      (0x09) /* expect client to disconnect */
+#define CMD_CAPABILITIES    (0x0a) /* capabilities accepted by client */
+#define CMD_CHUNK           (0x0b) /* chunk of a command (both directions) */
+#define CMD_NATIVE_CACHE    (0x0c) /* set caching policy of a native */
+#define CMD_SNAPSHOT        (0x0d) /* set attributes of the entity snapshot */
+#define CMD_QUERY_RADIUS    (0x0e) /* find entities within radius of a point */
+#define CMD_CALLBACK_FILTER (0x0f) /* set filter of a public call */
 #define CMD_ALIVE           (0x10) /* sign of live */
 
 /* send */
@@ -44,6 +51,8 @@
 #define CMD_PUBLIC_CALL     (0x13) /* public call */
 #define CMD_REPLY           (0x14) /* reply to find native or native invoke */
 #define CMD_ANNOUNCE        (0x15) /* announce with version */
+#define CMD_SNAPSHOT_FRAME  (0x16) /* changes of the entity snapshot */
+#define CMD_DRY_RUN_CALL    (0x17) /* public call without side effects */
 
 /* status marcos */
 #define STATUS_SET(v) status_ = (status)(status_ | (v))
@@ -55,10 +64,24 @@
 /** initializes and allocates required memory for the server instance */
 remote_server::remote_server(plugin *plg, commsvr *communication, const bool debug_check) :
     status_(status_none),
+    arena_(LEN_ARENA),
     communication_(communication),
     intermission_(plg),
     debug_check_(debug_check) {
 
+    std::string native_cache;
+    plg->config("native_cache", native_cache);
+    natives_.load_cache_config(native_cache);
+
+    grid_.set_cell_size(plg->config()->GetOptionDefault("spatial_cell_size",
+        GRID_DEFAULT_CELL_SIZE));
+
+    std::string callback_rate;
+    plg->config("callback_rate", callback_rate);
+    limiter_.load_config(callback_rate);
+
+    warmup_calls_ = plg->config()->GetOptionDefault("warmup_calls", 0u);
+
     intermission_.signal_starting();
     communication_->setup(this);
 }
@@ -68,6 +91,9 @@ remote_server::~remote_server() {
     if (communication_) {
         communication_->disconnect();
     }
+
+    chunk_reset();
+    arena_.log_stats();
 }
 
 #pragma endregion
@@ -75,7 +101,7 @@ remote_server::~remote_server() {
 #pragma region Commands
 
 CMD_DEFINE(cmd_ping) {
-    communication_->send(CMD_PONG, 0, NULL);
+    send(CMD_PONG, 0, NULL);
 }
 
 CMD_DEFINE(cmd_print) {
@@ -85,11 +111,35 @@ CMD_DEFINE(cmd_print) {
 CMD_DEFINE(cmd_alive) {
 }
 
+CMD_DEFINE(cmd_capabilities) {
+    if (buflen < sizeof(uint32_t) * 3) {
+        log_error("Invalid capabilities reply from client.");
+        return;
+    }
+
+    uint32_t *values = (uint32_t *)buf;
+
+    caps_ = values[0] & PLUGIN_CAPABILITIES;
+    caps_max_frame_ = values[1] < LEN_NETBUF ? values[1] : LEN_NETBUF;
+    if (caps_max_frame_ < LEN_CHUNK_MIN) {
+        caps_max_frame_ = LEN_CHUNK_MIN;
+    }
+    caps_compression_ = values[2] & PLUGIN_COMPRESSION;
+
+    log_debug("Negotiated capabilities 0x%x, max frame %d, compression 0x%x",
+        caps_, caps_max_frame_, caps_compression_);
+}
+
 CMD_DEFINE(cmd_register_call) {
     log_debug("Register call %s", buf);
     callbacks_.register_buffer(buf);
 }
 
+CMD_DEFINE(cmd_callback_filter) {
+    log_debug("Register filter %s", buf);
+    callbacks_.register_filter(buf, buflen);
+}
+
 CMD_DEFINE(cmd_find_native) {
     // copy callerid to output buffer
     *(uint16_t *)buftx_ = *(uint16_t *)buf;
@@ -98,25 +148,89 @@ CMD_DEFINE(cmd_find_native) {
 
     *(int32_t *)(buftx_ + sizeof(uint16_t)) = natives_.get_handle((char *)(buf + sizeof(uint16_t)));
     
-    communication_->send(CMD_RESPONSE, sizeof(int32_t) + sizeof(uint16_t), buftx_);
+    send(CMD_RESPONSE, sizeof(int32_t) + sizeof(uint16_t), buftx_);
+}
+
+CMD_DEFINE(cmd_query_radius) {
+    if (buflen < sizeof(uint16_t) + sizeof(uint32_t) + sizeof(float) * 4) {
+        log_error("Invalid radius query command.");
+        return;
+    }
+
+    /* copy callerid to output buffer */
+    *(uint16_t *)buftx_ = *(uint16_t *)buf;
+
+    uint32_t kinds = *(uint32_t *)(buf + sizeof(uint16_t));
+    float *args = (float *)(buf + sizeof(uint16_t) + sizeof(uint32_t));
+    int32_t *ids = (int32_t *)(buftx_ + sizeof(uint16_t) + sizeof(uint32_t));
+
+    uint32_t count = grid_.query(kinds, args[0], args[1], args[2], args[3],
+        ids, GRID_MAX_RESULTS);
+    if (count > GRID_MAX_RESULTS) {
+        count = GRID_MAX_RESULTS;
+    }
+
+    *(uint32_t *)(buftx_ + sizeof(uint16_t)) = count;
+
+    send(CMD_RESPONSE, sizeof(uint16_t) + sizeof(uint32_t) +
+        count * sizeof(int32_t), buftx_);
 }
 
 CMD_DEFINE(cmd_invoke_native) {
-    uint32_t txlen = LEN_NETBUF;
+    uint32_t txlen = LEN_NETBUF - sizeof(uint16_t);
     uint8_t *buftx = buftx_;
-
-    // copy callerid to output buffer
-    *(uint16_t *)buftx = *(uint16_t *)buf;
+    uint16_t callerid = *(uint16_t *)buf;
 
     buf += sizeof(uint16_t);
-    buftx += sizeof(uint16_t);
     buflen -= sizeof(uint16_t);
-    txlen -= sizeof(uint16_t);
 
-    natives_.invoke(buf, buflen, buftx, &txlen);
+    if (!natives_.invoke(buf, buflen, buftx + sizeof(uint16_t), &txlen) &&
+        txlen > LEN_NETBUF - sizeof(uint16_t)) {
+        /* the output does not fit the network buffer */
+        if (txlen > MESSAGE_QUEUE_MAX_LENGTH - sizeof(uint16_t)) {
+            log_error("Native output buffer is full.");
+            txlen = 0;
+        }
+        else {
+            buftx = arena_.alloc(txlen + sizeof(uint16_t));
+            natives_.invoke(buf, buflen, buftx + sizeof(uint16_t), &txlen);
+        }
+    }
+
     log_debug("Native invoked with %d buflen, response has %d buflen", buflen, txlen);
+
+    /* copy callerid to output buffer */
+    *(uint16_t *)buftx = callerid;
     txlen += sizeof(uint16_t);
-    communication_->send(CMD_RESPONSE, txlen, buftx_);
+    send(CMD_RESPONSE, txlen, buftx);
+}
+
+CMD_DEFINE(cmd_native_cache) {
+    if (buflen < sizeof(uint32_t) * 3) {
+        log_error("Invalid native cache command.");
+        return;
+    }
+
+    uint32_t *values = (uint32_t *)buf;
+    natives_.set_cache((int32_t)values[0], (native_cache_policy)values[1],
+        values[2]);
+}
+
+CMD_DEFINE(cmd_snapshot) {
+    if (buflen < sizeof(uint32_t)) {
+        log_error("Invalid snapshot command.");
+        return;
+    }
+
+    uint32_t attributes = *(uint32_t *)buf;
+
+    /* a keyframe is larger than the network buffers */
+    if (attributes && !has_cap(CAP_CHUNKED_FRAMES)) {
+        log_error("Entity snapshots require chunked frames.");
+        return;
+    }
+
+    snapshot_.set_attributes(attributes);
 }
 
 CMD_DEFINE(cmd_reconnect) {
@@ -160,7 +274,7 @@ CMD_DEFINE(cmd_start) {
             }
 
             /* send */
-            communication_->send(CMD_PUBLIC_CALL, len, buf_);
+            send(CMD_PUBLIC_CALL, len, buf_);
 
             /* receive */
             if (!cmd_receive_unhandled(&response, &len) || !response || 
@@ -169,7 +283,7 @@ CMD_DEFINE(cmd_start) {
                 break;
             }
 
-            delete[] response;
+            warm_up();
         }
         break;
     default:
@@ -225,6 +339,18 @@ bool remote_server::is_client_connected() {
     return communication_->is_connected() && STATUS_ISSET(status_client_connected);
 }
 
+/** a value indicating whether a capability has been negotiated */
+bool remote_server::has_cap(const uint32_t cap) const {
+    return (caps_ & cap) == cap;
+}
+
+/** resets the negotiated capabilities */
+void remote_server::caps_reset() {
+    caps_ = CAP_NONE;
+    caps_max_frame_ = LEN_NETBUF;
+    caps_compression_ = COMPRESSION_NONE;
+}
+
 /* try to let a client connect */
 bool remote_server::connect() {
     if (communication_->is_connected()) {
@@ -252,6 +378,10 @@ bool remote_server::connect() {
 
     STATUS_UNSET(status_client_reconnecting);
 
+    /* every client process compiles the game mode anew */
+    warmed_up_ = false;
+
+    caps_reset();
     cmd_send_announce();
 
     return true;
@@ -259,17 +389,35 @@ bool remote_server::connect() {
 
 /** sends the server announcement to the client */
 void remote_server::cmd_send_announce() {
-    /* send version */
-    uint8_t buf[sizeof(uint32_t) * 2 + 260];
+    /* announcement layout: protocol version, plugin version, null terminated
+     * working directory, supported capabilities, max frame size and supported
+     * compression methods. older clients stop reading at the terminator.
+     */
+    std::string cwd;
+    get_cwd(cwd);
+
+    uint32_t cwd_len = cwd.length() + 1;
+    uint32_t len = sizeof(uint32_t) * 5 + cwd_len;
+
+    if (len > LEN_NETBUF) {
+        cwd_len = LEN_NETBUF - sizeof(uint32_t) * 5;
+        len = LEN_NETBUF;
+    }
+
+    uint8_t *buf = buftx_;
     ((uint32_t *)buf)[0] = PLUGIN_PROTOCOL_VERSION;
     ((uint32_t *)buf)[1] = PLUGIN_VERSION;
+    buf += sizeof(uint32_t) * 2;
 
-    std::string cwd;
-    get_cwd(cwd);
+    memcpy(buf, cwd.c_str(), cwd_len - 1);
+    buf[cwd_len - 1] = '\0';
+    buf += cwd_len;
+
+    ((uint32_t *)buf)[0] = PLUGIN_CAPABILITIES;
+    ((uint32_t *)buf)[1] = MESSAGE_QUEUE_MAX_LENGTH;
+    ((uint32_t *)buf)[2] = PLUGIN_COMPRESSION;
 
-    memcpy(buf + sizeof(uint32_t) * 2, cwd.c_str(), cwd.length());
-    communication_->send(CMD_ANNOUNCE, sizeof(uint32_t) * 2 + cwd.length(),
-        buf);
+    send(CMD_ANNOUNCE, len, buftx_);
 
     log_info("Server announcement sent.");
     log_info("Hi from %s", cwd.c_str());
@@ -312,12 +460,18 @@ void remote_server::disconnect(const char *context, bool expected) {
     communication_->setup(this);
 
     STATUS_UNSET(status_client_connected);
+    caps_reset();
+    chunk_reset();
+    snapshot_.set_attributes(SNAPSHOT_NONE);
+    limiter_.reset();
+    arena_.log_stats();
 }
 
 /** receives a single command if available */
 cmd_status remote_server::cmd_receive_one(uint8_t **response, uint32_t *len) {
     uint8_t command;
     uint32_t command_len = LEN_NETBUF;
+    uint8_t *buf = buf_;
 
     assert(response);
     assert(len);
@@ -327,14 +481,24 @@ cmd_status remote_server::cmd_receive_one(uint8_t **response, uint32_t *len) {
         return conn_dead;
     }
 
-    cmd_status stat = communication_->receive(&command, buf_, &command_len);
+    cmd_status stat = communication_->receive(&command, buf, &command_len);
+
+    if (stat == too_small) {
+        /* the command does not fit the network buffer */
+        if (command_len > MESSAGE_QUEUE_MAX_LENGTH) {
+            return no_cmd;
+        }
 
-    if (stat == conn_dead || stat == no_cmd) {
-        return stat;
+        buf = arena_.alloc(command_len);
+        stat = communication_->receive(&command, buf, &command_len);
+    }
+
+    if (stat != unhandled) {
+        return stat == too_small ? no_cmd : stat;
     }
     
     store_time();
-    return cmd_process(command, buf_, command_len, response, len);
+    return cmd_process(command, buf, command_len, response, len);
 }
 
 /** receives commands until an unhandled command appears */
@@ -370,12 +534,22 @@ cmd_status remote_server::cmd_process(uint8_t cmd, uint8_t *buf,
         MAP_COMMAND(CMD_DISCONNECT, cmd_disconnect);
         MAP_COMMAND(CMD_START, cmd_start);
         MAP_COMMAND(CMD_ALIVE, cmd_alive);
+        MAP_COMMAND(CMD_CAPABILITIES, cmd_capabilities);
+        MAP_COMMAND(CMD_NATIVE_CACHE, cmd_native_cache);
+        MAP_COMMAND(CMD_SNAPSHOT, cmd_snapshot);
+        MAP_COMMAND(CMD_QUERY_RADIUS, cmd_query_radius);
+        MAP_COMMAND(CMD_CALLBACK_FILTER, cmd_callback_filter);
+
+        /* chunked commands */
+        case CMD_CHUNK:
+            return cmd_process_chunk(buf, buflen, resp, resplen);
 
         /* unmapped commands (unhandled) */
         case CMD_RESPONSE:
         default:
             if (buflen > 0) {
-                *resp = new uint8_t[buflen];
+                /* lives until the outermost tick or call has finished */
+                *resp = arena_.alloc(buflen);
                 memcpy(*resp, buf, buflen);
                 *resplen = buflen;
             }
@@ -385,6 +559,95 @@ cmd_status remote_server::cmd_process(uint8_t cmd, uint8_t *buf,
 #undef MAP_COMMAND
 }
 
+/** processes a chunk of a command */
+cmd_status remote_server::cmd_process_chunk(uint8_t *buf, uint32_t buflen,
+    uint8_t **resp, uint32_t *resplen) {
+    if (buflen < LEN_CHUNK_HEADER) {
+        log_error("Invalid command chunk.");
+        return handled;
+    }
+
+    uint8_t cmd = buf[0];
+    uint32_t total = *(uint32_t *)(buf + 1);
+
+    buf += LEN_CHUNK_HEADER;
+    buflen -= LEN_CHUNK_HEADER;
+
+    if (!chunk_buf_) {
+        /* the chunks may arrive over multiple ticks, so the command is not
+         * reassembled in the arena */
+        if (cmd == CMD_CHUNK || total > MESSAGE_QUEUE_MAX_LENGTH ||
+            !(chunk_buf_ = pool_.acquire(total, &chunk_cap_))) {
+            log_error("Invalid chunked command of %d bytes.", total);
+            return handled;
+        }
+
+        chunk_cmd_ = cmd;
+        chunk_len_ = total;
+        chunk_pos_ = 0;
+    }
+
+    if (cmd != chunk_cmd_ || total != chunk_len_ ||
+        buflen > chunk_len_ - chunk_pos_) {
+        log_error("Invalid command chunk.");
+        chunk_reset();
+        return handled;
+    }
+
+    memcpy(chunk_buf_ + chunk_pos_, buf, buflen);
+    chunk_pos_ += buflen;
+
+    if (chunk_pos_ < chunk_len_) {
+        return handled;
+    }
+
+    /* detach the command so it can receive chunked commands itself */
+    uint8_t *data = chunk_buf_;
+    uint32_t cap = chunk_cap_;
+    chunk_buf_ = NULL;
+
+    cmd_status stat = cmd_process(chunk_cmd_, data, chunk_len_, resp, resplen);
+
+    pool_.release(data, cap);
+    return stat;
+}
+
+/** discards the chunked command being received */
+void remote_server::chunk_reset() {
+    pool_.release(chunk_buf_, chunk_cap_);
+    chunk_buf_ = NULL;
+    chunk_cap_ = 0;
+}
+
+/** sends a command, split into chunks if required */
+bool remote_server::send(uint8_t cmd, uint32_t len, uint8_t *buf) {
+    if (len <= caps_max_frame_ || !has_cap(CAP_CHUNKED_FRAMES)) {
+        return communication_->send(cmd, len, buf);
+    }
+
+    arena_scope scope(&arena_);
+    uint8_t *chunk = arena_.alloc(caps_max_frame_);
+    uint32_t chunk_len;
+
+    for (uint32_t pos = 0; pos < len; pos += chunk_len) {
+        chunk_len = caps_max_frame_ - LEN_CHUNK_HEADER;
+        if (chunk_len > len - pos) {
+            chunk_len = len - pos;
+        }
+
+        chunk[0] = cmd;
+        *(uint32_t *)(chunk + 1) = len;
+        memcpy(chunk + LEN_CHUNK_HEADER, buf + pos, chunk_len);
+
+        if (!communication_->send(CMD_CHUNK, chunk_len + LEN_CHUNK_HEADER,
+            chunk)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 #pragma endregion
 
 void remote_server::terminate(const char *context) {
@@ -396,6 +659,9 @@ void remote_server::public_call(AMX *amx, const char *name, cell *params, cell *
     bool is_gmi = !strcmp(name, "OnGameModeInit");
     bool is_gme = !is_gmi && !strcmp(name, "OnGameModeExit");
 
+    /* calls deferred for a previous player are not delivered */
+    limiter_.release(name, params);
+
     if (is_gmi) {
         STATUS_SET(status_server_received_init);
     }
@@ -424,17 +690,96 @@ void remote_server::public_call(AMX *amx, const char *name, cell *params, cell *
         return;
     }
 
+    /* calls rejected by their filter are not forwarded */
+    if (!callbacks_.accepts(amx, name, params, retval)) {
+        return;
+    }
+
     /* prep network buffer */
     uint32_t len = LEN_NETBUF;
-    uint8_t *response = NULL;
-    if(!callbacks_.fill_call_buffer(amx, name, params, buf_, &len, true)) {
+    uint8_t *buf = buf_;
+    arena_scope scope(&arena_);
+    if(!callbacks_.fill_call_buffer(amx, name, params, buf, &len, true)) {
+        if (len <= LEN_NETBUF || len > MESSAGE_QUEUE_MAX_LENGTH) {
+            return;
+        }
+
+        /* the call does not fit the network buffer */
+        buf = arena_.alloc(len);
+        if(!callbacks_.fill_call_buffer(amx, name, params, buf, &len, true)) {
+            return;
+        }
+    }
+
+    /* calls within the rate limit window are deferred */
+    if (limiter_.limit(name, params)) {
+        limiter_.defer(buf, len, retval);
         return;
     }
-    
+
+    send_public_call(name, buf, len, retval);
+
+    /* callbacks are registered by the time the game mode has initialized */
+    if (is_gmi) {
+        warm_up();
+    }
+}
+
+/** calls every registered callback with synthetic arguments as dry runs */
+void remote_server::warm_up() {
+    if (!warmup_calls_ || warmed_up_ || !has_cap(CAP_DRY_RUN_CALLS)) {
+        return;
+    }
+    warmed_up_ = true;
+
+    std::vector<std::string> names;
+    callbacks_.registered(names);
+
+    startup_timer timer;
+    uint32_t count = 0;
+    arena_scope scope(&arena_);
+
+    for (size_t i = 0; i < names.size(); i++) {
+        const char *name = names[i].c_str();
+        uint32_t len = 0;
+
+        if (!strcmp(name, "OnGameModeInit") ||
+            !strcmp(name, "OnGameModeExit")) {
+            continue;
+        }
+
+        /* the responses are received into the network buffer, so the call
+         * is built apart from it */
+        callbacks_.fill_dry_run_buffer(name, NULL, &len, true);
+        if (len == 0) {
+            continue;
+        }
+
+        uint8_t *buf = arena_.alloc(len);
+        if (!callbacks_.fill_dry_run_buffer(name, buf, &len, true)) {
+            continue;
+        }
+
+        for (uint32_t n = 0; n < warmup_calls_; n++) {
+            send_public_call(name, buf, len, NULL, true);
+        }
+
+        timer.mark(name);
+        count++;
+    }
+
+    log_info("Warm-up of %u callbacks: %s.", count, timer.summary().c_str());
+}
+
+/** sends a filled call buffer and waits for the response */
+void remote_server::send_public_call(const char *name, uint8_t *buf,
+    uint32_t len, cell *retval, bool dry_run) {
+    uint8_t *response = NULL;
+
     mutex_.lock();
 
     /* send */
-    communication_->send(CMD_PUBLIC_CALL, len, buf_);
+    send(dry_run ? CMD_DRY_RUN_CALL : CMD_PUBLIC_CALL, len, buf);
 
     /* receive */
     if(!cmd_receive_unhandled(&response, &len) || !response || len == 0) {
@@ -450,13 +795,15 @@ void remote_server::public_call(AMX *amx, const char *name, cell *params, cell *
         /* get return value */
         *retval = *((uint32_t *)(response + 1));
     }
-
-    delete[] response;
 }
 
 /** called when a server tick occurs */
 void remote_server::tick() {
     mutex_.lock();
+    arena_.enter();
+
+    natives_.tick();
+    grid_.tick();
 
     if (is_client_connected() && 
         STATUS_ISSET(status_client_started | status_client_received_init) && 
@@ -467,7 +814,32 @@ void remote_server::tick() {
         /* only send tick if no paused debugger is detected */
         if (!is_debugging(true)) {
             tick_ = time(NULL);
-            communication_->send(CMD_TICK, 0, NULL);
+
+            /* deliver the latest calls of ended rate limit windows */
+            callback_limiter::due_call call;
+            while (limiter_.next_due(&call)) {
+                if (call.len == 0) {
+                    continue;
+                }
+
+                /* the slot may be reused by calls made during delivery */
+                uint8_t *buf = arena_.alloc(call.len);
+                memcpy(buf, call.buf, call.len);
+                send_public_call(call.name, buf, call.len, NULL);
+            }
+
+            /* entity state is sent ahead of the tick so the tick handlers of
+             * the game mode can read the current values */
+            if (snapshot_.attributes()) {
+                uint32_t frame_len;
+                snapshot_.update();
+                const uint8_t *frame = snapshot_.encode(&frame_len);
+                if (frame) {
+                    send(CMD_SNAPSHOT_FRAME, frame_len, (uint8_t *)frame);
+                }
+            }
+
+            send(CMD_TICK, 0, NULL);
         }
     }
 
@@ -481,9 +853,12 @@ void remote_server::tick() {
 
         if (response) {
             log_error("Unhandled response in tick.");
-            delete[] response;
         }
     } while (stat != no_cmd && stat != conn_dead);
 
+    /* free buffers of past spikes */
+    pool_.trim();
+
+    arena_.leave();
     mutex_.unlock();
 }
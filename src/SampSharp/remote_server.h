@@ -27,8 +27,17 @@
 #include "natives_map.h"
 #include "commsvr.h"
 #include "intermission.h"
+#include "capabilities.h"
+#include "buffer_pool.h"
+#include "arena.h"
+#include "entity_snapshot.h"
+#include "spatial_grid.h"
+#include "callback_limiter.h"
 
 #define LEN_NETBUF          (1024 * 32)
+#define LEN_CHUNK_HEADER    (sizeof(uint8_t) + sizeof(uint32_t))
+#define LEN_CHUNK_MIN       (1024)
+#define LEN_ARENA           (1024 * 64)
 
 /** a remote running game mode server */
 class remote_server : public server {
@@ -63,6 +72,26 @@ private: /* fields */
     uint8_t buf_[LEN_NETBUF];
     /** buffer tx */
     uint8_t buftx_[LEN_NETBUF];
+    /** pool of buffers for chunked commands being received */
+    buffer_pool pool_;
+    /** allocator for buffers living until the end of a tick or call */
+    arena arena_;
+    /** per-tick snapshot of entity state sent to the client */
+    entity_snapshot snapshot_;
+    /** index of entity positions for radius queries */
+    spatial_grid grid_;
+    /** rate limits of high-frequency callbacks */
+    callback_limiter limiter_;
+    /** buffer of the chunked command being received */
+    uint8_t *chunk_buf_ = NULL;
+    /** capacity of the chunked command buffer */
+    uint32_t chunk_cap_ = 0;
+    /** length of the chunked command being received */
+    uint32_t chunk_len_ = 0;
+    /** number of bytes of the chunked command received */
+    uint32_t chunk_pos_ = 0;
+    /** the chunked command being received */
+    uint8_t chunk_cmd_ = 0;
     /** comms */
     commsvr *communication_;
     /** lock for callbacks/ticks */
@@ -79,6 +108,16 @@ private: /* fields */
     bool is_debug_ = false;
     /** number of ticks skipped while paused by debugger */
     int ticks_skipped_ = 0;
+    /** number of dry runs of each callback after the game mode has started */
+    uint32_t warmup_calls_ = 0;
+    /** indicates whether the callbacks of the client have been warmed up */
+    bool warmed_up_ = false;
+    /** capabilities negotiated with the client */
+    uint32_t caps_ = CAP_NONE;
+    /** maximum frame size accepted by the client */
+    uint32_t caps_max_frame_ = LEN_NETBUF;
+    /** compression methods negotiated with the client */
+    uint32_t caps_compression_ = COMPRESSION_NONE;
 
 private: /* methods */
     /* update status for new connection */
@@ -87,6 +126,10 @@ private: /* methods */
     void cmd_send_announce();
     /** a value indicating whether the client is connected */
     bool is_client_connected();
+    /** a value indicating whether a capability has been negotiated */
+    bool has_cap(uint32_t cap) const;
+    /** resets the negotiated capabilities */
+    void caps_reset();
     /** receives commands until an unhandled command appears */
     bool cmd_receive_unhandled(uint8_t **response, uint32_t *len);
     /** receive an unhandled command */
@@ -94,6 +137,19 @@ private: /* methods */
     /** processes a command */
     cmd_status cmd_process(uint8_t cmd, uint8_t *buf, uint32_t buflen,
         uint8_t **resp, uint32_t *resplen);
+    /** processes a chunk of a command */
+    cmd_status cmd_process_chunk(uint8_t *buf, uint32_t buflen,
+        uint8_t **resp, uint32_t *resplen);
+    /** discards the chunked command being received */
+    void chunk_reset();
+    /** sends a filled call buffer and waits for the response */
+    void send_public_call(const char *name, uint8_t *buf, uint32_t len,
+        cell *retval, bool dry_run = false);
+    /** calls every registered callback with synthetic arguments as dry runs
+     * so the client is compiled before players join */
+    void warm_up();
+    /** sends a command, split into chunks if required */
+    bool send(uint8_t cmd, uint32_t len, uint8_t *buf);
     /** store current time as last interaction time */
     void store_time();
     /** a guessed value whether the client is paused by a debugger */
@@ -107,11 +163,16 @@ private: /* commands */
     CMD_DECLARE(cmd_ping);
     CMD_DECLARE(cmd_print);
     CMD_DECLARE(cmd_register_call);
+    CMD_DECLARE(cmd_callback_filter);
     CMD_DECLARE(cmd_find_native);
     CMD_DECLARE(cmd_invoke_native);
     CMD_DECLARE(cmd_reconnect);
     CMD_DECLARE(cmd_start);
     CMD_DECLARE(cmd_disconnect);
     CMD_DECLARE(cmd_alive);
+    CMD_DECLARE(cmd_capabilities);
+    CMD_DECLARE(cmd_native_cache);
+    CMD_DECLARE(cmd_snapshot);
+    CMD_DECLARE(cmd_query_radius);
 #undef CMD_DECLARE
 };
@@ -0,0 +1,302 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "simd.h"
+#include <string.h>
+#include <emmintrin.h>
+#include <immintrin.h>
+
+/* the plugin is built for x86 without assuming any SIMD extensions;
+ * kernels are compiled for their instruction set and selected at runtime.
+ */
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#  define SIMD_TARGET_SSE2
+#  define SIMD_TARGET_AVX2
+#else
+#  include <cpuid.h>
+#  define SIMD_TARGET_SSE2 __attribute__((target("sse2")))
+#  define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#define SIMD_SSE2   (1 << 0)
+#define SIMD_AVX2   (1 << 1)
+
+/** detects the supported instruction sets */
+static int detect() {
+    int features = 0;
+    unsigned int regs[4] = { 0 };
+
+#if defined(_MSC_VER)
+    __cpuid((int *)regs, 0);
+    unsigned int max = regs[0];
+    __cpuid((int *)regs, 1);
+#else
+    unsigned int max = __get_cpuid_max(0, NULL);
+    __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#endif
+
+    if (regs[3] & (1 << 26)) {
+        features |= SIMD_SSE2;
+    }
+
+    /* avx2 requires the os to save the ymm registers */
+    bool osxsave = (regs[2] & (1 << 27)) != 0;
+    if (max >= 7 && osxsave) {
+#if defined(_MSC_VER)
+        unsigned long long xcr0 = _xgetbv(0);
+        __cpuidex((int *)regs, 7, 0);
+#else
+        unsigned int xcr0_lo, xcr0_hi;
+        __asm__ ("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+        unsigned long long xcr0 = xcr0_lo;
+        __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        if ((xcr0 & 0x6) == 0x6 && (regs[1] & (1 << 5))) {
+            features |= SIMD_AVX2;
+        }
+    }
+
+    return features;
+}
+
+static int features() {
+    static int features_ = detect();
+    return features_;
+}
+
+#pragma region Scalar
+
+static uint32_t strlen_scalar(const cell *src, uint32_t pos) {
+    while (src[pos]) {
+        pos++;
+    }
+    return pos;
+}
+
+static void widen_scalar(const char *src, cell *dst, uint32_t len,
+    uint32_t pos) {
+    for (; pos < len; pos++) {
+        dst[pos] = (cell)(signed char)src[pos];
+    }
+}
+
+static uint32_t narrow_scalar(const cell *src, char *dst, uint32_t size,
+    uint32_t pos) {
+    for (; pos < size; pos++) {
+        if (!(dst[pos] = (char)src[pos])) {
+            return pos;
+        }
+    }
+    return SIMD_NOT_TERMINATED;
+}
+
+#pragma endregion
+
+#pragma region SSE2
+
+/* vector loads are aligned and a vector is only loaded if the previous one
+ * did not contain the terminator, so loads never cross into a page past the
+ * end of the string */
+
+SIMD_TARGET_SSE2
+static uint32_t strlen_sse2(const cell *src) {
+    uint32_t pos = 0;
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; ((uintptr_t)(src + pos) & 15); pos++) {
+        if (!src[pos]) {
+            return pos;
+        }
+    }
+
+    for (;; pos += 4) {
+        __m128i v = _mm_load_si128((const __m128i *)(src + pos));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(v, zero))) {
+            return strlen_scalar(src, pos);
+        }
+    }
+}
+
+SIMD_TARGET_SSE2
+static uint32_t narrow_sse2(const cell *src, char *dst, uint32_t size) {
+    uint32_t pos = 0;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = _mm_set1_epi32(0xff);
+
+    for (; ((uintptr_t)(src + pos) & 15); pos++) {
+        if (pos >= size) {
+            return SIMD_NOT_TERMINATED;
+        }
+        if (!(dst[pos] = (char)src[pos])) {
+            return pos;
+        }
+    }
+
+    /* 16 cells per iteration; the last block leaves room for the
+     * terminator */
+    for (; pos + 16 < size; pos += 16) {
+        const __m128i *p = (const __m128i *)(src + pos);
+        __m128i a, b, c, d;
+
+#define SIMD_LOAD_SSE2(v, i) \
+        v = _mm_load_si128(p + i); \
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(v, zero))) break
+
+        SIMD_LOAD_SSE2(a, 0);
+        SIMD_LOAD_SSE2(b, 1);
+        SIMD_LOAD_SSE2(c, 2);
+        SIMD_LOAD_SSE2(d, 3);
+#undef SIMD_LOAD_SSE2
+
+        /* truncate to bytes like amx_GetString */
+        __m128i ab = _mm_packs_epi32(_mm_and_si128(a, mask),
+            _mm_and_si128(b, mask));
+        __m128i cd = _mm_packs_epi32(_mm_and_si128(c, mask),
+            _mm_and_si128(d, mask));
+        _mm_storeu_si128((__m128i *)(dst + pos), _mm_packus_epi16(ab, cd));
+    }
+
+    return narrow_scalar(src, dst, size, pos);
+}
+
+SIMD_TARGET_SSE2
+static void widen_sse2(const char *src, cell *dst, uint32_t len) {
+    uint32_t pos = 0;
+
+    for (; pos + 16 <= len; pos += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + pos));
+
+        /* duplicate each byte into the top of its cell and shift it back
+         * down to sign extend */
+        __m128i lo = _mm_unpacklo_epi8(v, v);
+        __m128i hi = _mm_unpackhi_epi8(v, v);
+        __m128i *p = (__m128i *)(dst + pos);
+        _mm_storeu_si128(p, _mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 24));
+        _mm_storeu_si128(p + 1,
+            _mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 24));
+        _mm_storeu_si128(p + 2,
+            _mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 24));
+        _mm_storeu_si128(p + 3,
+            _mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 24));
+    }
+
+    widen_scalar(src, dst, len, pos);
+}
+
+#pragma endregion
+
+#pragma region AVX2
+
+SIMD_TARGET_AVX2
+static void widen_avx2(const char *src, cell *dst, uint32_t len) {
+    uint32_t pos = 0;
+
+    for (; pos + 32 <= len; pos += 32) {
+        __m256i *p = (__m256i *)(dst + pos);
+        const __m128i *s = (const __m128i *)(src + pos);
+        __m128i lo = _mm_loadu_si128(s);
+        __m128i hi = _mm_loadu_si128(s + 1);
+
+        _mm256_storeu_si256(p, _mm256_cvtepi8_epi32(lo));
+        _mm256_storeu_si256(p + 1,
+            _mm256_cvtepi8_epi32(_mm_srli_si128(lo, 8)));
+        _mm256_storeu_si256(p + 2, _mm256_cvtepi8_epi32(hi));
+        _mm256_storeu_si256(p + 3,
+            _mm256_cvtepi8_epi32(_mm_srli_si128(hi, 8)));
+    }
+
+    widen_scalar(src, dst, len, pos);
+}
+
+SIMD_TARGET_AVX2
+static uint32_t narrow_avx2(const cell *src, char *dst, uint32_t size) {
+    uint32_t pos = 0;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i mask = _mm256_set1_epi32(0xff);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    for (; ((uintptr_t)(src + pos) & 31); pos++) {
+        if (pos >= size) {
+            return SIMD_NOT_TERMINATED;
+        }
+        if (!(dst[pos] = (char)src[pos])) {
+            return pos;
+        }
+    }
+
+    /* 32 cells per iteration */
+    for (; pos + 32 < size; pos += 32) {
+        const __m256i *p = (const __m256i *)(src + pos);
+        __m256i a, b, c, d;
+
+#define SIMD_LOAD_AVX2(v, i) \
+        v = _mm256_load_si256(p + i); \
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(v, zero))) break
+
+        SIMD_LOAD_AVX2(a, 0);
+        SIMD_LOAD_AVX2(b, 1);
+        SIMD_LOAD_AVX2(c, 2);
+        SIMD_LOAD_AVX2(d, 3);
+#undef SIMD_LOAD_AVX2
+
+        /* packs operate per 128-bit lane; restore the order afterwards */
+        __m256i ab = _mm256_packs_epi32(_mm256_and_si256(a, mask),
+            _mm256_and_si256(b, mask));
+        __m256i cd = _mm256_packs_epi32(_mm256_and_si256(c, mask),
+            _mm256_and_si256(d, mask));
+        __m256i bytes = _mm256_permutevar8x32_epi32(
+            _mm256_packus_epi16(ab, cd), order);
+        _mm256_storeu_si256((__m256i *)(dst + pos), bytes);
+    }
+
+    return narrow_scalar(src, dst, size, pos);
+}
+
+#pragma endregion
+
+uint32_t simd_cells_strlen(const cell *src) {
+    if (features() & SIMD_SSE2) {
+        return strlen_sse2(src);
+    }
+    return strlen_scalar(src, 0);
+}
+
+uint32_t simd_narrow_cells(const cell *src, char *dst, uint32_t size) {
+    int f = features();
+
+    if (f & SIMD_AVX2) {
+        return narrow_avx2(src, dst, size);
+    }
+    if (f & SIMD_SSE2) {
+        return narrow_sse2(src, dst, size);
+    }
+    return narrow_scalar(src, dst, size, 0);
+}
+
+void simd_widen_chars(const char *src, cell *dst, uint32_t len) {
+    int f = features();
+
+    if (f & SIMD_AVX2) {
+        widen_avx2(src, dst, len);
+    }
+    else if (f & SIMD_SSE2) {
+        widen_sse2(src, dst, len);
+    }
+    else {
+        widen_scalar(src, dst, len, 0);
+    }
+}
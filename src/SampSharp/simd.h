@@ -0,0 +1,45 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <inttypes.h>
+#include <sampgdk/sampgdk.h>
+
+#define SIMD_NOT_TERMINATED     (0xffffffff)
+
+/** a value indicating whether the cell string is packed */
+#define simd_is_packed(str) ((ucell)*(str) > UNPACKEDMAX)
+
+/* c linkage; also used by the sampgdk fake amx */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** returns the length of an unpacked, zero terminated cell string */
+uint32_t simd_cells_strlen(const cell *src);
+
+/** narrows an unpacked, zero terminated cell string into dst, writing at most
+ * size bytes including the terminator. returns the length of the string or
+ * SIMD_NOT_TERMINATED if it does not fit */
+uint32_t simd_narrow_cells(const cell *src, char *dst, uint32_t size);
+
+/** widens len chars into cells, sign extending like amx_SetString */
+void simd_widen_chars(const char *src, cell *dst, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -219,26 +219,36 @@ cmd_status sock_unix::receive(uint8_t *command, uint8_t *buf, uint32_t *len) {
         return conn_dead;
     }
 
-    count = read(sockc_, (char *)buf_, LEN_NETBUF);
-    if (count > 0) {
-        queue_messages_.add(buf_, count);
-    }
-    else if (count < 0 && errno != EAGAIN) {
-        logerr("Failed to read from socket. %s");
-        svr_->terminate("Failed to read from socket.");
-        return conn_dead;
-    }
+    /* keep reading while the read buffer is filled up; large commands
+     * span multiple reads */
+    do {
+        count = read(sockc_, (char *)buf_, LEN_NETBUF);
+        if (count > 0) {
+            queue_messages_.add(buf_, count);
+        }
+        else if (count < 0 && errno != EAGAIN) {
+            logerr("Failed to read from socket. %s");
+            svr_->terminate("Failed to read from socket.");
+            return conn_dead;
+        }
+    } while (count == LEN_NETBUF && !queue_messages_.can_get());
 
     if (!queue_messages_.can_get()) {
         return no_cmd;
     }
 
-    *len = queue_messages_.get(command, buf, *len);
-    if (*len == MESSAGE_QUEUE_BUFFER_TOO_SMALL) {
-        log_error("Message buffer too small.");
-        len = 0;
+    uint32_t result = queue_messages_.get(command, buf, *len);
+    if (result == MESSAGE_QUEUE_BUFFER_TOO_SMALL) {
+        *len = queue_messages_.length();
+        return too_small;
+    }
+    if (result == MESSAGE_QUEUE_FRAME_TOO_LARGE) {
+        log_error("Message too large.");
+        *len = 0;
+        return no_cmd;
     }
 
+    *len = result;
     return unhandled;
 }
 
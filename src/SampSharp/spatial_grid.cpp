@@ -0,0 +1,129 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "spatial_grid.h"
+#include <algorithm>
+#include <math.h>
+#include <sampgdk/sampgdk.h>
+
+spatial_grid::spatial_grid() :
+    cell_size_(GRID_DEFAULT_CELL_SIZE),
+    used_(false) {
+}
+
+void spatial_grid::set_cell_size(const float size) {
+    if (size > 0) {
+        cell_size_ = size;
+    }
+}
+
+int32_t spatial_grid::cell_of(const float value) const {
+    return (int32_t)floorf(value / cell_size_);
+}
+
+/** packs the cell coordinates into a sortable key */
+uint32_t spatial_grid::key_of(const int32_t cx, const int32_t cy) {
+    return ((uint32_t)(cx + 0x8000) & 0xffff) << 16 |
+        ((uint32_t)(cy + 0x8000) & 0xffff);
+}
+
+void spatial_grid::tick() {
+    if (used_) {
+        rebuild();
+    }
+}
+
+void spatial_grid::rebuild() {
+    entry e;
+    entries_.clear();
+
+    int32_t players = GetPlayerPoolSize();
+    for (int32_t i = 0; i <= players; i++) {
+        if (IsPlayerConnected(i) && GetPlayerPos(i, &e.x, &e.y, &e.z)) {
+            e.kind = GRID_PLAYERS;
+            e.id = i;
+            e.key = key_of(cell_of(e.x), cell_of(e.y));
+            entries_.push_back(e);
+        }
+    }
+
+    int32_t vehicles = GetVehiclePoolSize();
+    for (int32_t i = 1; i <= vehicles; i++) {
+        if (GetVehicleModel(i) && GetVehiclePos(i, &e.x, &e.y, &e.z)) {
+            e.kind = GRID_VEHICLES;
+            e.id = i;
+            e.key = key_of(cell_of(e.x), cell_of(e.y));
+            entries_.push_back(e);
+        }
+    }
+
+    std::sort(entries_.begin(), entries_.end());
+}
+
+uint32_t spatial_grid::query(uint32_t kinds, float x, float y, float z,
+    float radius, int32_t *ids, uint32_t capacity) {
+    if (!used_) {
+        used_ = true;
+        rebuild();
+    }
+
+    if (radius < 0) {
+        return 0;
+    }
+
+    uint32_t count = 0;
+    const float r2 = radius * radius;
+    const int32_t cx1 = cell_of(x - radius), cx2 = cell_of(x + radius);
+    const int32_t cy1 = cell_of(y - radius), cy2 = cell_of(y + radius);
+
+    /* scan all entries if the radius covers more cells than there are
+     * entries; this also prevents visiting a wrapped around key twice */
+    if ((uint64_t)(cx2 - cx1 + 1) * (uint64_t)(cy2 - cy1 + 1) >
+        entries_.size()) {
+        for (const entry &e : entries_) {
+            float dx = e.x - x, dy = e.y - y, dz = e.z - z;
+            if ((e.kind & kinds) && dx * dx + dy * dy + dz * dz <= r2) {
+                if (count < capacity) {
+                    ids[count] = e.id;
+                }
+                count++;
+            }
+        }
+        return count;
+    }
+
+    entry probe;
+    for (int32_t cx = cx1; cx <= cx2; cx++) {
+        for (int32_t cy = cy1; cy <= cy2; cy++) {
+            probe.key = key_of(cx, cy);
+
+            std::vector<entry>::const_iterator it = std::lower_bound(
+                entries_.begin(), entries_.end(), probe);
+
+            for (; it != entries_.end() && it->key == probe.key; ++it) {
+                float dx = it->x - x, dy = it->y - y, dz = it->z - z;
+                if ((it->kind & kinds) && dx * dx + dy * dy + dz * dz <= r2) {
+                    if (count < capacity) {
+                        ids[count] = it->id;
+                    }
+                    count++;
+                }
+            }
+        }
+    }
+
+    return count;
+}
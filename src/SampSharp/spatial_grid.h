@@ -0,0 +1,58 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <inttypes.h>
+#include <vector>
+
+#define GRID_PLAYERS            (1 << 0)
+#define GRID_VEHICLES           (1 << 1)
+#define GRID_ALL                (GRID_PLAYERS | GRID_VEHICLES)
+#define GRID_DEFAULT_CELL_SIZE  (50.0f)
+#define GRID_MAX_RESULTS        (1000 + 2000) /* all players and vehicles */
+
+/** a uniform grid index of player and vehicle positions */
+class spatial_grid
+{
+public:
+    spatial_grid();
+    /** sets the size of the grid cells in world units */
+    void set_cell_size(float size);
+    /** rebuilds the index if it has been queried before */
+    void tick();
+    /** finds the entities of the specified kinds within radius of a point;
+     * writes up to capacity ids and returns the number of entities found */
+    uint32_t query(uint32_t kinds, float x, float y, float z, float radius,
+        int32_t *ids, uint32_t capacity);
+private:
+    struct entry {
+        uint32_t key;
+        uint32_t kind;
+        int32_t id;
+        float x, y, z;
+        bool operator<(const entry &other) const { return key < other.key; }
+    };
+    int32_t cell_of(float value) const;
+    static uint32_t key_of(int32_t cx, int32_t cy);
+    void rebuild();
+    /** entries sorted by cell key */
+    std::vector<entry> entries_;
+    float cell_size_;
+    /** set once the grid has been queried; the grid is only maintained
+     * while it is in use */
+    bool used_;
+};
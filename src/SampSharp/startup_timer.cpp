@@ -0,0 +1,54 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "startup_timer.h"
+#include "platforms.h"
+#include <stdio.h>
+
+typedef std::chrono::duration<double, std::milli> ms_duration;
+
+startup_timer::startup_timer() {
+    start();
+}
+
+void startup_timer::start() {
+    start_ = last_ = std::chrono::steady_clock::now();
+    phases_.clear();
+}
+
+void startup_timer::mark(const char *name) {
+    std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+
+    phases_.push_back(std::make_pair(name, ms_duration(now - last_).count()));
+    last_ = now;
+}
+
+std::string startup_timer::summary() const {
+    char buf[64];
+    std::string result;
+
+    for (size_t i = 0; i < phases_.size(); i++) {
+        sampsharp_sprintf(buf, sizeof(buf), "%s %.1f ms, ",
+            phases_[i].first, phases_[i].second);
+        result.append(buf);
+    }
+
+    sampsharp_sprintf(buf, sizeof(buf), "total %.1f ms",
+        ms_duration(last_ - start_).count());
+    result.append(buf);
+    return result;
+}
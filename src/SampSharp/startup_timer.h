@@ -0,0 +1,39 @@
+// SampSharp
+// Copyright 2018 Tim Potze
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** measures the durations of consecutive startup phases */
+class startup_timer
+{
+public:
+    startup_timer();
+    /** discards all phases and starts the first phase */
+    void start();
+    /** ends the current phase and starts the next phase */
+    void mark(const char *name);
+    /** formats the durations of the phases and the total duration */
+    std::string summary() const;
+private:
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point last_;
+    std::vector<std::pair<const char *, double> > phases_;
+};